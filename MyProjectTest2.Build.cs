@@ -13,7 +13,11 @@ public class MyProjectTest2 : ModuleRules
 			"InputCore", 
 			"HeadMountedDisplay", 
 			"EnhancedInput",
+			"AIModule",
+			"NavigationSystem",
 			"UMG",
+			"Slate",
+			"SlateCore",
 			"Niagara" // Add this line to include the Niagara module
 		});
 	}
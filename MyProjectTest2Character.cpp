@@ -4,6 +4,7 @@
 
 #include "AI_Character.h"
 #include "AI_Elite.h"
+#include "HealingVial.h"
 #include "EngineUtils.h"
 #include "Engine/LocalPlayer.h"
 #include "Camera/CameraComponent.h"
@@ -14,7 +15,21 @@
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "InputActionValue.h"
+#include "CombatFrameSubsystem.h"
+#include "CombatAudioSubsystem.h"
+#include "CombatFXSubsystem.h"
+#include "CombatLightSubsystem.h"
+#include "FootstepSubsystem.h"
 #include "Projectile_Arrow_Base.h"
+#include "ProjectilePoolSubsystem.h"
+#include "ProjectileSimSubsystem.h"
+#include "PlayerAimRigComponent.h"
+#include "PlayerAudioCueComponent.h"
+#include "PlayerDodgeComponent.h"
+#include "PlayerGlyphComponent.h"
+#include "PlayerHUDViewModel.h"
+#include "PlayerInventoryComponent.h"
+#include "PlayerStaminaComponent.h"
 #include "Components/PointLightComponent.h"
 #include "Components/SpotLightComponent.h"
 #include "Engine/DamageEvents.h"
@@ -77,6 +92,8 @@ AMyProjectTest2Character::AMyProjectTest2Character()
 	// 	ProjectileClass = ProjectileBP.Class;
 	// }
 
+	HealingVialClass = AHealingVial::StaticClass();
+
 	DefaultCameraPosition = FollowCamera->GetRelativeLocation();
 	DefaultCameraRotation = FollowCamera->GetRelativeRotation();
 
@@ -103,6 +120,16 @@ AMyProjectTest2Character::AMyProjectTest2Character()
 	TargetHealth = 100.0f;
 	HealthLerpSpeed = 5.0f;
 	bIsHealthLerping = false;
+
+	// On-demand gameplay components, each ticks only while it has work
+	StaminaComponent = CreateDefaultSubobject<UPlayerStaminaComponent>(TEXT("Stamina"));
+	InventoryComponent = CreateDefaultSubobject<UPlayerInventoryComponent>(TEXT("Inventory"));
+	AudioCueComponent = CreateDefaultSubobject<UPlayerAudioCueComponent>(TEXT("AudioCues"));
+	GlyphComponent = CreateDefaultSubobject<UPlayerGlyphComponent>(TEXT("Glyph"));
+	AimRigComponent = CreateDefaultSubobject<UPlayerAimRigComponent>(TEXT("AimRig"));
+	DodgeComponent = CreateDefaultSubobject<UPlayerDodgeComponent>(TEXT("Dodge"));
+
+	HUDViewModel = CreateDefaultSubobject<UPlayerHUDViewModel>(TEXT("HUDViewModel"));
 }
 	
 
@@ -304,6 +331,7 @@ void AMyProjectTest2Character::BeginPlay()
 		UE_LOG(LogTemp, Warning, TEXT("CrossbowMesh is not assigned in Blueprint!"));
 	}
 
+	// The glyph and vial lights only serve as templates; the combat light manager lends the real ones
 	if (HealingGlyphMesh && HealingGlyphLight)
 	{
 		HealingGlyphMesh->SetVisibility(false);
@@ -318,11 +346,32 @@ void AMyProjectTest2Character::BeginPlay()
 	BowArrowMesh->SetVisibility(false);
 	HealingVialMesh->SetVisibility(false);
 	HealingAmbientLight->SetVisibility(false);
+	SetVialAmbienceVisible(false);
 
 	// Initialize visibility for bow on back and quiver arrows
 	if (BowOnBackRef) BowOnBackRef->SetVisibility(true);
 	UpdateQuiverArrowsVisibility();
 
+	// Spawn arrows up front so the first shots of a fight don't hitch
+	if (UProjectilePoolSubsystem* ProjectilePool = UProjectilePoolSubsystem::Get(this))
+	{
+		ProjectilePool->Prewarm(ProjectileClass, ProjectilePoolPrewarm);
+	}
+
+	// Same for thrown vials: their mesh, actors and break effect are all ready before the first heal
+	PrewarmVials();
+
+	// Footsteps follow ground distance covered, and each one lets nearby grunts hear the player
+	if (UFootstepSubsystem* Footsteps = UFootstepSubsystem::Get(this))
+	{
+		FFootstepSettings FootstepSettings;
+		FootstepSettings.Sound = WalkingSound;
+		FootstepSettings.StrideLength = FootstepStrideLength;
+		FootstepSettings.NoiseLoudness = 1.f;
+		FootstepSettings.CanStep = [this]() { return !IsAttacking && !IsRolling; };
+		Footsteps->Register(this, MoveTemp(FootstepSettings));
+	}
+
 	// Get the CharacterMovementComponent and cast it to UCharacterMovementComponent*
 	// UCharacterMovementComponent* CharacterMovement = Cast<UCharacterMovementComponent>(GetMovementComponent());
 	//
@@ -387,6 +436,7 @@ void AMyProjectTest2Character::Look(const FInputActionValue& Value)
 		// add yaw and pitch input to controller
 		AddControllerYawInput(LookAxisVector.X);
 		AddControllerPitchInput(LookAxisVector.Y);
+		AimRigComponent->Wake();
 	}
 }
 
@@ -473,6 +523,7 @@ void AMyProjectTest2Character::StartAiming()
 
 		GetCharacterMovement()->StopMovementImmediately();
 		GetCharacterMovement()->MaxWalkSpeed = 0.f;
+		AimRigComponent->Wake();
 	}
 }
 
@@ -480,6 +531,12 @@ void AMyProjectTest2Character::StopAiming()
 {
 	bIsAiming = false;
 	AimTime = 0.0f;
+	bHasPlayedBowAimSound = false;
+	if (BowPullbackAudio && BowPullbackAudio->IsPlaying())
+	{
+		BowPullbackAudio->Stop();
+		BowPullbackAudio = nullptr; // Reset for the next use
+	}
 	FollowCamera->SetRelativeLocation(DefaultCameraPosition);
 	FollowCamera->SetRelativeRotation(DefaultCameraRotation);
 	bIsBowEquipped = false;
@@ -508,6 +565,8 @@ void AMyProjectTest2Character::Roll()
 		GetCharacterMovement()->MaxWalkSpeed = 700.f; // Set your desired roll speed
 		bIsWaitingForDoubleTap = false;
 		PauseStaminaRegeneration();
+		DodgeComponent->Wake();
+		AimRigComponent->Wake();
 	}
 }
 
@@ -515,10 +574,8 @@ void AMyProjectTest2Character::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	// if (GetCharacterMovement()->IsMovingOnGround())
-	// {
-	// 	bCanJump = true;
-	// }
+	// Stamina, inventory, audio cues, glyph, aim rig and dodge run in their own components
+	// and only tick while they have work. What is left here is cheap per-frame bookkeeping.
 
 	if (FindNearestEliteBoss())
 	{
@@ -526,15 +583,13 @@ void AMyProjectTest2Character::Tick(float DeltaTime)
 	}
 	// Check if the elite boss is within the reach of judgement
 	
-	// Regenerate arrows
-	RegenerateInventory(DeltaTime);
-	
 	if (GetCharacterMovement()->IsMovingOnGround())
 	{
 		isJumping = false;
 		bCanJump = true;
 		//bIsWaitingForDoubleTap = false;
 		JumpFrameCounter = 0; // Reset the jump frame counter when the character stops jumping
+		JumpTime = 0.f;
 		//JumpTimeCounter = 0.0f;
 		bIsWaitingForDoubleTap = true;
 	}
@@ -544,93 +599,17 @@ void AMyProjectTest2Character::Tick(float DeltaTime)
 		DeathTime += DeathTime;
 	}
 
-	if(!bIsAiming)
-	{
-		bHasPlayedBowAimSound = false;
-		if (BowPullbackAudio && BowPullbackAudio->IsPlaying())
-		{
-			BowPullbackAudio->Stop();
-			BowPullbackAudio = nullptr; // Reset for the next use
-			bHasPlayedBowAimSound = false; // Reset flag so it can play again
-		}
-	}
-	
-	if (CachedSpeed > 0.f && !IsAttacking && !IsRolling && !isJumping)
-	{
-
-		// Calculate the time interval between footsteps based on the character's speed
-		float FootstepInterval = FMath::Clamp(100.f / CachedSpeed, 0.f, 1.0f); // Adjust the range as needed
-		FootstepInterval += .2f;
-		
-		FootstepTimer += DeltaTime;
-
-		if (FootstepTimer >= FootstepInterval)
-		{
-			//UGameplayStatics::PlaySound2D(this, FootstepSound, 1.0f, 1.0f);
-			UGameplayStatics::PlaySoundAtLocation(
-				this,           // World context object
-				WalkingSound,// Sound to play
-				GetActorLocation(), // Location to play sound
-				1.0f,           // Volume multiplier
-				1.0f,           // Pitch multiplier
-				0.0f,           // Start time
-				nullptr,        // Attenuation settings
-				nullptr         // Concurrency settings
-			);
-		
-			FootstepTimer = 0.0f;
-		 }
-	}
-	else
-	{
-		FootstepTimer = 0.0f;
-	}
-
-	if (CurrentDisplayHealth <= (MaxHealth * 0.8f))
-	{
-
-		// Calculate the time interval between footsteps based on the character's speed
-		float HeartInterval = FMath::Clamp(MaxHealth / CurrentDisplayHealth, 0.f, 1.0f); // Adjust the range as needed
-		HeartInterval -= .3f;
-		
-		HeartTimer += DeltaTime;
-
-		if (HeartTimer >= HeartInterval)
-		{
-			//UGameplayStatics::PlaySound2D(this, FootstepSound, 1.0f, 1.0f);
-			float HealthPercentage = CurrentDisplayHealth / MaxHealth;
-			float VolumeMultiplier = FMath::Lerp(2.0f, 0.5f, HealthPercentage);
-
-			UGameplayStatics::PlaySoundAtLocation(
-				this,           // World context object
-				HeartSound,     // Sound to play
-				GetActorLocation(), // Location to play sound
-				VolumeMultiplier,   // Volume multiplier (will be louder at lower health)
-				1.0f,           // Pitch multiplier
-				0.0f,           // Start time
-				nullptr,        // Attenuation settings
-				nullptr         // Concurrency settings
-			);
-		
-			HeartTimer = 0.0f;
-		}
-	}
-	else
-	{
-		HeartTimer = 0.0f;
-	}
-
-	CrossBowOnBeltRef->SetVisibility(!bInQuickAttack);
-	
-	if (bIsStaminaRegenPaused)
+	// Weapon meshes only need touching when the state that picks them changes
+	const int32 WeaponVisibilityKey = (bIsSmashingVial ? 1 : 0)
+		| (bInQuickAttack ? 2 : 0)
+		| ((bIsAiming || bIsBowEquipped) ? 4 : 0)
+		| (Arrows << 3);
+	if (WeaponVisibilityKey != LastWeaponVisibilityKey)
 	{
-		StaminaRegenPauseTimer += DeltaTime;
-		if (StaminaRegenPauseTimer >= StaminaRegenCooldown)
-		{
-			bIsStaminaRegenPaused = false;
-		}
+		LastWeaponVisibilityKey = WeaponVisibilityKey;
+		CrossBowOnBeltRef->SetVisibility(!bInQuickAttack);
+		UpdateWeaponVisibility();
 	}
-	//WasJumping = isJumping;
 	
 	if (FMath::IsNearlyEqual(CurrentDisplayHealth, 0.f, 0.5f))
 	{
@@ -657,46 +636,11 @@ void AMyProjectTest2Character::Tick(float DeltaTime)
 			CurrentDisplayHealth = TargetHealth;
 			bIsHealthLerping = false;
 		}
+
+		// Heartbeat follows the displayed health
+		AudioCueComponent->Wake();
 	}
 	
-	if (bIsHealingGlyphActive && bIsHealingGlyphFading)
-	{
-		HealingGlyphTimer += DeltaTime;
-		float FadeProgress = FMath::Clamp(HealingGlyphTimer / HealingGlyphFadeOutDuration, 0.0f, 1.0f);
-        
-		if (HealingGlyphLight)
-		{
-			// Gradually reduce light intensity
-			float NewIntensity = FMath::Lerp(HealingGlyphInitialIntensity, 0.0f, FadeProgress);
-			HealingGlyphLight->SetIntensity(NewIntensity);
-		}
-        
-		// You can also fade the mesh opacity if needed
-		if (HealingGlyphMesh)
-		{
-			// Create a dynamic material instance if needed
-			UMaterialInterface* Material = HealingGlyphMesh->GetMaterial(0);
-			if (Material)
-			{
-				UMaterialInstanceDynamic* DynamicMaterial = Cast<UMaterialInstanceDynamic>(Material);
-				if (!DynamicMaterial)
-				{
-					DynamicMaterial = UMaterialInstanceDynamic::Create(Material, this);
-					HealingGlyphMesh->SetMaterial(0, DynamicMaterial);
-				}
-                
-				if (DynamicMaterial)
-				{
-					// Assuming the material has an opacity parameter
-					// You might need to adjust this based on your material setup
-					DynamicMaterial->SetScalarParameterValue(TEXT("Opacity"), 1.0f - FadeProgress);
-				}
-			}
-		}
-	}
-	UpdateHealingGlyph(DeltaTime);
-	UpdateWeaponVisibility();
-	
 	if (bIsAiming)
 	{
 		if (AimTime < 5.0f)
@@ -726,34 +670,24 @@ void AMyProjectTest2Character::Tick(float DeltaTime)
 	}
 
 
-	// Don't process movement or actions if in damage state
+	// Don't process movement or actions if in damage state; the HUD still has to follow the hit
 	if (bIsInDamageState)
 	{
+		PushHUDState();
 		return;
 	}
 
-	// Check if the character is falling
 	if (GetCharacterMovement())
 	{
+		CachedVelocity = GetCharacterMovement()->Velocity;
+		CachedSpeed = CachedVelocity.Size();
 		bIsFalling = GetCharacterMovement()->IsFalling();
 	}
 
-	// Arrow shooting cooldown
-	if (!bCanShootArrow)
-	{
-		ArrowCooldownTimer += DeltaTime;
-		if (ArrowCooldownTimer >= ArrowCooldownDuration)
-		{
-			bCanShootArrow = true;
-		}
-	}
-
-
-	if (GetCharacterMovement())
+	// Moving means a camera that has to keep tracking the neck
+	if (CachedSpeed > 0.f)
 	{
-		CachedVelocity = GetCharacterMovement()->Velocity;
-		CachedSpeed = CachedVelocity.Size();
-		bIsFalling = GetCharacterMovement()->IsFalling();
+		AimRigComponent->Wake();
 	}
 
 	// Arrow shooting cooldown
@@ -766,162 +700,21 @@ void AMyProjectTest2Character::Tick(float DeltaTime)
 		}
 	}
 
-	if (bIsStaminaRegenPaused)
-	{
-		StaminaRegenPauseTimer += DeltaTime;
-		if (StaminaRegenPauseTimer >= StaminaRegenCooldown)
-		{
-			bIsStaminaRegenPaused = false;
-		}
-	}
-
-	if (Stamina <= 0 && !StaminaDepletion)
-	{
-		PauseStaminaRegeneration();
-		Stamina = 0;
-		StaminaZeroTimer = 0.0f;
-		StaminaDepletion = true;
-		StaminaRegenRate = BaseStaminaRegenRate; // Reset regen rate when stamina is depleted
-    
-		// Reduce movement speed when stamina is depleted
-		if (!IsRolling && !bIsAiming) // Don't override special movement states
-		{
-			GetCharacterMovement()->MaxWalkSpeed = 125.f; // Reduced speed when stamina is drained
-		}
-	}
-	// Stamina regeneration
-	if (Stamina > 0 && !StaminaDepletion && !bIsStaminaRegenPaused)
-	{
-		// Increase regeneration rate over time
-		StaminaRegenRate = FMath::Min(StaminaRegenRate + (DeltaTime * StaminaRegenAcceleration), MaxStaminaRegenRate);
-    
-		// Apply the current regeneration rate
-		Stamina += DeltaTime * StaminaRegenRate;
-		Stamina = FMath::Clamp(Stamina, 0.f, MaxStamina);
-    
-		// Restore normal movement speed if it was reduced due to stamina depletion
-		if (GetCharacterMovement()->MaxWalkSpeed == 125.f && !IsRolling && !bIsAiming && !WasSprinting && !isCrouching)
-		{
-			GetCharacterMovement()->MaxWalkSpeed = 500.f; // Restore to normal speed
-		}
-	}
-	else if (StaminaDepletion)
-	{
-		StaminaZeroTimer += DeltaTime;
-		if (StaminaZeroTimer >= StaminaRecoveryDelay)
-		{
-			Stamina = 1.f;
-			StaminaDepletion = false;
-			StaminaRegenRate = BaseStaminaRegenRate; // Reset to base rate when recovery begins
-        
-			// Restore normal movement speed when stamina starts regenerating
-			if (GetCharacterMovement()->MaxWalkSpeed == 125.f && !IsRolling && !bIsAiming && !WasSprinting && !isCrouching)
-			{
-				GetCharacterMovement()->MaxWalkSpeed = 500.f; // Restore to normal speed
-			}
-		}
-	}
-
-	if (WasSprinting && !IsRolling)
-	{
-		Stamina -= SprintCost;
-		if (Stamina < SprintCost)
-		{
-			StopSprinting();
-		}
-	}
-
-	FramesSinceLastJump++;
+	// Jump timers advance with simulated time, so the jump windows last as long at any sim rate
+	const UCombatFrameSubsystem* CombatFrame = UCombatFrameSubsystem::Get(this);
+	const float SimTime = CombatFrame ? CombatFrame->GetSimStepsThisFrame() * CombatFrame->GetFixedStep() : DeltaTime;
+	TimeSinceLastJump += SimTime;
 
 	JumpCooldownTimer += DeltaTime;
 	AttackCooldownTimer += DeltaTime;
 
 	if (isJumping)
 	{
-		JumpFrameCounter++;
+		JumpTime += SimTime;
+		JumpFrameCounter = FMath::FloorToInt32(JumpTime * 60.f);
 	}
 
-	if (IsAttacking)
-	{
-		if (AttackTimeCounter < AttackDuration * 0.3f)
-		{
-			FVector AttackDirection = GetActorForwardVector();
-			AttackDirection.Normalize();
-			FVector AttackMovement = AttackDirection * 100.f * DeltaTime;
-			GetCharacterMovement()->MoveUpdatedComponent(AttackMovement, GetActorRotation(), true);
-		}
-
-
-		AttackTimeCounter += DeltaTime;
-		if (AttackTimeCounter >= AttackDuration)
-		{
-			StopAttack();
-			AttackFinished = true;
-		}
-	}
-
-	// If the character is rolling, increment the frame counter
-	if (IsRolling)
-	{
-		RollDuration += DeltaTime;
-
-		// Ensure movement direction is valid, defaulting to forward if no input
-		FVector RollDirection = MoveDirection.IsNearlyZero() ? GetActorForwardVector() : MoveDirection;
-
-		// Normalize before modifying it
-		RollDirection.Normalize();
-
-		// Rotate the player to face the roll direction
-		FRotator RollRotation = RollDirection.Rotation();
-		//SetActorRotation(FRotator(0.f, RollRotation.Yaw, 0.f)); // Keep only yaw rotation to avoid tilting
-
-		// Define roll speed and lift (adjust as needed)
-		RollDirection = RollDirection * 1100.f + FVector(0.f, 0.f, 200.f);
-
-		// Normalize again to maintain consistent speed
-		RollDirection.Normalize();
-
-		// Calculate roll movement
-		FVector RollMovement = RollDirection * GetCharacterMovement()->MaxWalkSpeed * DeltaTime;
-
-		// Apply movement
-		GetCharacterMovement()->MoveUpdatedComponent(RollMovement, GetActorRotation(), true);
-
-		// Stop rolling after reaching duration
-		if (RollDuration >= MaxRollDuration)
-		{
-			IsRolling = false;
-			StopRolling();
-			RollFinished = true;
-		}
-	}
-
-	if (bIsAiming)
-	{
-		AimTime += 0.15;
-		AimBow();
-	}
-	else
-	{
-		StopAiming();
-	}
-	if (!bIsAiming) // Ensure this only runs when not aiming
-	{
-		// Get the neck socket world location
-		FVector NeckSocketLocation = GetMesh()->GetSocketLocation("NeckSocket");
-
-		// Calculate direction to the neck socket (from the camera)
-		FVector DirectionToNeck = NeckSocketLocation - FollowCamera->GetComponentLocation();
-		DirectionToNeck.Normalize();
-
-		// Calculate the rotation to face the neck socket
-		FRotator TargetRotation = DirectionToNeck.Rotation();
-
-		// Smoothly interpolate the camera's rotation to face the neck
-		FollowCamera->SetWorldRotation(TargetRotation); // Adjust interpolation speed
-	}
-	
-
+	PushHUDState();
 } 
 
 void AMyProjectTest2Character::StopRolling()
@@ -952,6 +745,7 @@ void AMyProjectTest2Character::StopRolling()
 		AttackCooldownTimer = 0.0f;
 		AttackTimeCounter = 0.0f;
 		IsAttacking = true;
+		DodgeComponent->Wake();
 	}
 
 	bCanAim = true;
@@ -1025,6 +819,7 @@ void AMyProjectTest2Character::StartAttack()
 			CheckForMeleeHits();
 			IsAttacking = true;
 			PauseStaminaRegeneration();
+			DodgeComponent->Wake();
 
 			AAI_Character* NearestEnemy = nullptr;
 			float NearestDistanceSquared = FLT_MAX;  // Start with the largest possible distance
@@ -1189,44 +984,35 @@ void AMyProjectTest2Character::ShootBow()
 		ShootDirection = WorldDirection;
 	}
 
-	// Spawn the projectile at the left-hand socket location
-	AProjectile_Arrow_Base* Projectile = GetWorld()->SpawnActor<AProjectile_Arrow_Base>(
+	// Fan the shot out around the aim direction; a single arrow goes straight down it.
+	// Each arrow in the fan comes out of the quiver, so a short quiver fires a smaller fan
+	const int32 VolleyCount = FMath::Clamp(BowVolleyCount, 1, FMath::Max(Arrows, 1));
+	TArray<FVector, TInlineAllocator<8>> ShootDirections;
+	for (int32 ArrowIndex = 0; ArrowIndex < VolleyCount; ++ArrowIndex)
+	{
+		const float YawOffset = (ArrowIndex - (VolleyCount - 1) * 0.5f) * BowVolleySpread;
+		ShootDirections.Add(ShootDirection.RotateAngleAxis(YawOffset, FVector::UpVector));
+	}
+
+	// Arrows come from the pool at the left-hand socket location and go straight into the projectile sim
+	UProjectileSimSubsystem* ProjectileSim = UProjectileSimSubsystem::Get(this);
+	const float ArrowSpeed = 2500.f;
+	const int32 Fired = ProjectileSim ? ProjectileSim->FireVolley(
 		ProjectileClass,
 		SocketTransform.GetLocation(),
-		ShootDirection.Rotation()
-	);
+		ShootDirections,
+		ArrowSpeed,
+		BowArrowDamage,
+		this,
+		BowReleaseSound
+	) : 0;
 
-    if (Projectile)
+    if (Fired > 0)
     {
     	LastArrowTime = 0.f;
-    	UGameplayStatics::PlaySoundAtLocation(
-					this,           // World context object
-					BowReleaseSound,// Sound to play
-					GetActorLocation(), // Location to play sound
-					1.0f,           // Volume multiplier
-					1.0f,           // Pitch multiplier
-					0.0f,           // Start time
-					nullptr,        // Attenuation settings
-					nullptr         // Concurrency settings
-				);
-        Arrows--;
+        Arrows = FMath::Max(Arrows - Fired, 0);
+        InventoryComponent->Wake();
     	UpdateQuiverArrowsVisibility();
-    	Projectile->SetDamage(100.f);
-        // Set the velocity for the arrow
-        float ArrowSpeed = 2500.f;
-        FVector LaunchVelocity = ShootDirection * ArrowSpeed;
-
-        // Apply velocity to the projectile
-        Projectile->SetVelocity(LaunchVelocity);
-
-        // Set this character as the instigator (for damage attribution)
-        Projectile->SetInstigator(this);
-
-        // If the projectile has a mesh with physics enabled, apply impulse
-        if (Projectile->GetArrowMesh() && Projectile->GetArrowMesh()->IsSimulatingPhysics())
-        {
-            Projectile->GetArrowMesh()->AddImpulse(LaunchVelocity, NAME_None, true);
-        }
 
     	// Set the shoot animation flag and start the timer
     	bDidShoot = true;
@@ -1313,87 +1099,15 @@ void AMyProjectTest2Character::AimBow()
     }
 }
 
-void AMyProjectTest2Character::RegenerateInventory(float DeltaTime)
-{
-
-	if (MaxArrows > Arrows)
-	{
-		LastArrowTime += DeltaTime;
-	}
-	if (MaxCrossbowArrows > Crossbow_arrows)
-	{
-		LastCrossbowTime += DeltaTime;
-	}
-	if (MaxHealVials > Health_vials)
-	{
-		LastVialTime += DeltaTime;
-	}
-	
-	if (MaxArrows > Arrows && LastArrowTime > LastArrowTimeGoal)
-	{
-		Arrows = FMath::Clamp(Arrows + 1, 0.0, MaxArrows);
-		LastArrowTime = 0.f;
-
-		UGameplayStatics::PlaySoundAtLocation(
-			this,           // World context object
-			BowRestockSound,// Sound to play
-			GetActorLocation(), // Location to play sound
-			4.5f,           // Volume multiplier
-			1.0f,           // Pitch multiplier
-			0.0f,           // Start time
-			nullptr,        // Attenuation settings
-			nullptr         // Concurrency settings
-		);
-	}
-
-	// Regenerate crossbow arrows
-	if (MaxCrossbowArrows > Crossbow_arrows && LastCrossbowTime > LastCrossbowTimeGoal)
-	{
-		Crossbow_arrows = FMath::Clamp(Crossbow_arrows + 1, 0.0f, MaxCrossbowArrows);
-		LastCrossbowTime = 0.f;
-		UGameplayStatics::PlaySoundAtLocation(
-			this,           // World context object
-			CrossbowRestockSound,// Sound to play
-			GetActorLocation(), // Location to play sound
-			2.5f,           // Volume multiplier
-			1.0f,           // Pitch multiplier
-			0.0f,           // Start time
-			nullptr,        // Attenuation settings
-			nullptr         // Concurrency settings
-		);
-	}
-
-	// Regenerate heal vials
-	if (MaxHealVials > Health_vials && LastVialTime > LastVialTimeGoal)
-	{
-		Health_vials = FMath::Clamp(Health_vials + 1, 0.0f, MaxHealVials);
-		LastVialTime = 0.f;
-		UGameplayStatics::PlaySoundAtLocation(
-			this,           // World context object
-			VialRestockSound,// Sound to play
-			GetActorLocation(), // Location to play sound
-			0.4f,           // Volume multiplier
-			1.0f,           // Pitch multiplier
-			0.0f,           // Start time
-			nullptr,        // Attenuation settings
-			nullptr         // Concurrency settings
-		);
-	}
-}
-
 bool AMyProjectTest2Character::FindNearestEliteBoss()
 {
-	AAI_Elite* FoundBoss = Cast<AAI_Elite>(UGameplayStatics::GetActorOfClass(GetWorld(), AAI_Elite::StaticClass()));
-
-	if (FoundBoss)
+	// Only search the level again once the cached boss is gone
+	if (!IsValid(EliteBoss))
 	{
-		EliteBoss = FoundBoss;
-		if (EliteBoss->Health > 0.0f)
-		{
-			return true;
-		}
+		EliteBoss = Cast<AAI_Elite>(UGameplayStatics::GetActorOfClass(GetWorld(), AAI_Elite::StaticClass()));
 	}
-	return false;
+
+	return IsValid(EliteBoss) && EliteBoss->Health > 0.0f;
 }
 
 
@@ -1444,6 +1158,7 @@ void AMyProjectTest2Character::ToggleWeapon()
 	{
 		// Toggle between bow and swords
 		bIsBowEquipped = !bIsBowEquipped;
+		AimRigComponent->Wake();
         
 		// Update weapon visibility based on new state
 		UpdateWeaponVisibility();
@@ -1469,13 +1184,13 @@ void AMyProjectTest2Character::UpdateWeaponVisibility()
             if (SwordLeftMeshInner) SwordLeftMeshInner->SetVisibility(false);
 
             HealingVialMesh->SetVisibility(true);
-            HealingAmbientLight->SetVisibility(true);
+            SetVialAmbienceVisible(true);
             return;
         }
         else
         {
             HealingVialMesh->SetVisibility(false);
-            HealingAmbientLight->SetVisibility(false);
+            SetVialAmbienceVisible(false);
         }
 
         // Show the appropriate weapon based on state
@@ -1543,15 +1258,11 @@ float AMyProjectTest2Character::TakeDamage(float DamageAmount, FDamageEvent cons
 
 	if (!bIsDead)
 	{
-		UGameplayStatics::PlaySoundAtLocation(
+		UCombatAudioSubsystem::PlayCue(
 				this,           // World context object
 				TakeDamageSound,// Sound to play
 				GetActorLocation(), // Location to play sound
-				1.0f,           // Volume multiplier
-				1.0f,           // Pitch multiplier
-				0.0f,           // Start time
-				nullptr,        // Attenuation settings
-				nullptr         // Concurrency settings
+				ECombatAudioCategory::Player
 			);
 	}
 	
@@ -1577,11 +1288,12 @@ float AMyProjectTest2Character::TakeDamage(float DamageAmount, FDamageEvent cons
 		}
         
 		// Spawn the effect at the hit location
-		UNiagaraFunctionLibrary::SpawnSystemAtLocation(
-			GetWorld(),    // Get world context
+		UCombatFXSubsystem::SpawnAtLocation(
+			this,          // World context
 			HitEffect,     // Niagara system to spawn
 			HitLocation,   // Location of the hit
-			HitRotation    // Rotation to align with surface
+			HitRotation,   // Rotation to align with surface
+			ECombatFXPriority::Critical
 		);
 	}
     
@@ -1622,18 +1334,33 @@ float AMyProjectTest2Character::GetDisplayHealth() const
 	return CurrentDisplayHealth;
 }
 
+void AMyProjectTest2Character::PushHUDState()
+{
+	// The view model drops anything the HUD wouldn't show differently, so this is cheap when nothing moved
+	HUDViewModel->SetHealth(Health, MaxHealth);
+	HUDViewModel->SetDisplayHealth(CurrentDisplayHealth);
+	HUDViewModel->SetStamina(Stamina, MaxStamina);
+	HUDViewModel->SetArrows(Arrows, MaxArrows);
+	HUDViewModel->SetCrossbowArrows(Crossbow_arrows, MaxCrossbowArrows);
+	HUDViewModel->SetHealthVials(Health_vials, MaxHealVials);
+
+	auto RestockProgress = [](int32 Count, int32 MaxCount, float Time, float Goal)
+	{
+		return Count < MaxCount && Goal > 0.f ? FMath::Clamp(Time / Goal, 0.f, 1.f) : 0.f;
+	};
+	HUDViewModel->SetArrowRestock(RestockProgress(Arrows, MaxArrows, LastArrowTime, LastArrowTimeGoal));
+	HUDViewModel->SetCrossbowRestock(RestockProgress(Crossbow_arrows, MaxCrossbowArrows, LastCrossbowTime, LastCrossbowTimeGoal));
+	HUDViewModel->SetVialRestock(RestockProgress(Health_vials, MaxHealVials, LastVialTime, LastVialTimeGoal));
+}
+
 void AMyProjectTest2Character::HandleDeath()
 {
 	if (bIsDead) return;
-	UGameplayStatics::PlaySoundAtLocation(
+	UCombatAudioSubsystem::PlayCue(
 			this,           // World context object
 			DeathSound, // Sound to play
 			GetActorLocation(), // Location to play sound
-			1.0f,           // Volume multiplier
-			1.0f,           // Pitch multiplier
-			0.0f,           // Start time
-			nullptr,        // Attenuation settings
-			nullptr         // Concurrency settings
+			ECombatAudioCategory::Player
 		);
 	// Prevent further input and movement
 	bIsDead = true;
@@ -1729,15 +1456,12 @@ void AMyProjectTest2Character::CheckForMeleeHits()
 
 					// Apply damage to the hit actor
 					HitActor->TakeDamage(DamageAmount, FDamageEvent(), GetController(), this);
-					UGameplayStatics::PlaySoundAtLocation(
+					UCombatAudioSubsystem::PlayCue(
 			this,           // World context object
 			MeleeHitSound,// Sound to play
 			GetActorLocation(), // Location to play sound
-			0.5f,           // Volume multiplier
-			1.0f,           // Pitch multiplier
-			0.0f,           // Start time
-			nullptr,        // Attenuation settings
-			nullptr         // Concurrency settings
+			ECombatAudioCategory::Impact,
+			0.5f            // Volume multiplier
 		);
 				}
 			}
@@ -1747,15 +1471,11 @@ void AMyProjectTest2Character::CheckForMeleeHits()
 	// Play swing sound regardless of whether we hit anything
 	if (MeleeSwingSound && AttackTimeCounter == 0.0f)
 	{
-		UGameplayStatics::PlaySoundAtLocation(
+		UCombatAudioSubsystem::PlayCue(
 			this,           // World context object
 			MeleeSwingSound,// Sound to play
 			GetActorLocation(), // Location to play sound
-			1.0f,           // Volume multiplier
-			1.0f,           // Pitch multiplier
-			0.0f,           // Start time
-			nullptr,        // Attenuation settings
-			nullptr         // Concurrency settings
+			ECombatAudioCategory::Weapon
 		);
 	}
 	
@@ -1873,141 +1593,103 @@ void AMyProjectTest2Character::StartVialSmashAnimation()
     
     // Show the vial mesh
     if (HealingVialMesh) HealingVialMesh->SetVisibility(true);
-    if (HealingAmbientLight) HealingAmbientLight->SetVisibility(true);
-    
-    // Set a timer to throw the vial after a short delay (during animation)
-    GetWorldTimerManager().SetTimer(
-        VialThrowTimerHandle,
-        this,
-        &AMyProjectTest2Character::ThrowVial,
-        0.2f,  // Throw vial 0.2 seconds into the animation
-        false
-    );
+    SetVialAmbienceVisible(true);
     
-    // Set a timer to end the animation after the full duration
-    float VialSmashAnimationDuration = 0.3f;
-    GetWorldTimerManager().SetTimer(
-        VialSmashAnimationTimerHandle,
-        this,
-        &AMyProjectTest2Character::EndVialSmashAnimation,
-        VialSmashAnimationDuration,
-        false
-    );
+    // Throw the vial 0.2 seconds into the animation and end the animation at 0.3 seconds
+    VialSmashMove.Reset()
+        .Wait(0.2f)
+        .Then([this]() { ThrowVial(); })
+        .Wait(0.1f)
+        .Finally([this](bool bWasCancelled) { EndVialSmashAnimation(bWasCancelled); });
+    VialSmashMove.Start(this);
 }
 
 void AMyProjectTest2Character::ThrowVial()
 {
-	UGameplayStatics::PlaySoundAtLocation(
+	UCombatAudioSubsystem::PlayCue(
 				this,           // World context object
 				VialThrowSound,// Sound to play
 				GetActorLocation(), // Location to play sound
-				1.0f,           // Volume multiplier
-				1.0f,           // Pitch multiplier
-				0.0f,           // Start time
-				nullptr,        // Attenuation settings
-				nullptr         // Concurrency settings
+				ECombatAudioCategory::Weapon
 			);
 	Health_vials--;
+	InventoryComponent->Wake();
 	HealingGlyphTimer = 0.0f;
 	HealingGlyphInitialIntensity = 0.0f;
-    // Spawn a simple vial static mesh that falls to the ground
-    UStaticMesh* VialMesh = nullptr;
-    
-    // Try to get the same mesh that's used for the HealingVialMesh component
-    if (HealingVialMesh && HealingVialMesh->GetStaticMesh())
+    // Drop one of the pooled vials from the hand with a bit of forward momentum and a random spin
+    if (AHealingVial* Vial = AcquireVial())
     {
-        VialMesh = HealingVialMesh->GetStaticMesh();
-    }
-    else
-    {
-        // Fallback to a default mesh if available
-        static ConstructorHelpers::FObjectFinder<UStaticMesh> DefaultVialMeshFinder(TEXT("/Game/Meshes/SM_HealingVial"));
-        if (DefaultVialMeshFinder.Succeeded())
-        {
-            VialMesh = DefaultVialMeshFinder.Object;
-        }
-    }
-    
-    if (VialMesh)
-    {
-        // Get the hand socket location
-        FVector SpawnLocation = GetMesh()->GetSocketLocation("RightHandSocket");
-        
-        // Create a new static mesh component
-        UStaticMeshComponent* FallingVial = NewObject<UStaticMeshComponent>(this);
-        FallingVial->RegisterComponent();
-        FallingVial->SetStaticMesh(VialMesh);
-        FallingVial->SetWorldLocation(SpawnLocation);
-        FallingVial->SetWorldRotation(GetActorRotation());
-        
-        // Set up physics properties for better bouncing
-        FallingVial->SetSimulatePhysics(true);
-        FallingVial->SetCollisionProfileName(TEXT("PhysicsActor"));
-        //FallingVial->SetEnableGravity(true);
-        FallingVial->SetNotifyRigidBodyCollision(true); // Enable hit notifications
-
-        FallingVial->SetPhysicsMaxAngularVelocityInDegrees(1000.0f);
-        FallingVial->SetPhysicsLinearVelocity(FVector::ZeroVector);
-        FallingVial->SetPhysicsAngularVelocityInDegrees(FVector::ZeroVector);
-        FallingVial->SetLinearDamping(0.1f);
-        FallingVial->SetAngularDamping(0.1f);
-        
-        // Match the scale of the original vial if possible
-        if (HealingVialMesh)
-        {
-            FallingVial->SetWorldScale3D(HealingVialMesh->GetComponentScale());
-        }
-        
-        // Apply a small impulse to make it fall naturally with a bit of forward momentum
         FVector ThrowDirection = -GetActorUpVector() + (GetMesh()->GetForwardVector() * 0.2) + (GetMesh()->GetRightVector().Normalize() * 0.2);
         ThrowDirection.Normalize();
-        FallingVial->AddImpulse(ThrowDirection * 800.0f, NAME_None, true);
-        
-        // Add a small random rotation
+
         FVector RandomRotation(FMath::RandRange(-1.0f, 1.0f), 
                               FMath::RandRange(-1.0f, 1.0f), 
                               FMath::RandRange(-1.0f, 1.0f));
-        FallingVial->AddTorqueInRadians(RandomRotation * 5000.0f, NAME_None, true);
-
-    	FallingVial->SetCollisionObjectType(ECC_PhysicsBody);
-    	FallingVial->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-    	//FallingVial->SetCollisionResponseToAllChannels(ECR_Block);
-    	FallingVial->SetEnableGravity(true);
-    	FallingVial->SetUseCCD(true);  // Enable Continuous Collision Detection
-    	//FallingVial->SetCollisionProfileName(TEXT("OverlapAllDynamic"));
-    	FallingVial->OnComponentHit.AddDynamic(this, &AMyProjectTest2Character::OnVialHit);
-    	//FallingVial->OnComponentBeginOverlap.AddDynamic(this, &AMyProjectTest2Character::OnVialOverlap);
-        
-        // Set up hit notification
-        //FallingVial->OnComponentHit.AddDynamic(this, &AMyProjectTest2Character::OnVialHit);
-        
-        // Store the component pointer for hit detection
-        TempFallingVial = FallingVial;
-        
-        // Set up a timer to destroy the component after a delay
-        FTimerHandle DestroyTimerHandle;
-        FTimerDelegate DestroyDelegate;
-        DestroyDelegate.BindLambda([this, FallingVial]()
-        {
-            if (FallingVial && FallingVial->IsValidLowLevel())
-            {
-                // Play break effects at the vial's current location before destroying it
-                //PlayVialBreakEffects(FallingVial->GetComponentLocation());
-                FallingVial->DestroyComponent();
-                
-                // Clear the temporary reference
-                if (TempFallingVial == FallingVial)
-                {
-                    TempFallingVial = nullptr;
-                }
-            }
-        });
-        GetWorldTimerManager().SetTimer(DestroyTimerHandle, DestroyDelegate, 5.0f, false); // Increased to 5 seconds
+
+        // Match the scale of the original vial if possible
+        const FVector Scale = HealingVialMesh ? HealingVialMesh->GetComponentScale() : FVector::OneVector;
+        const FTransform ThrowTransform(GetActorRotation(), GetMesh()->GetSocketLocation("RightHandSocket"), Scale);
+        Vial->Throw(ThrownVialMesh, ThrowTransform, ThrowDirection * 800.0f, RandomRotation * 5000.0f);
     }
     
     // Hide the attached vial mesh now that we've thrown the physics one
     if (HealingVialMesh) HealingVialMesh->SetVisibility(false);
-    if (HealingAmbientLight) HealingAmbientLight->SetVisibility(false);
+    SetVialAmbienceVisible(false);
+}
+
+void AMyProjectTest2Character::PrewarmVials()
+{
+	ThrownVialMesh = HealingVialMesh && HealingVialMesh->GetStaticMesh() ? HealingVialMesh->GetStaticMesh() : FallbackVialMesh.LoadSynchronous();
+
+	if (UCombatFXSubsystem* CombatFX = UCombatFXSubsystem::Get(this))
+	{
+		CombatFX->Prewarm(GlassShatter);
+	}
+
+	if (!HealingVialClass || !ThrownVialMesh)
+	{
+		return;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = this;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	for (int32 Index = VialPool.Num(); Index < VialPoolSize; ++Index)
+	{
+		AHealingVial* Vial = GetWorld()->SpawnActor<AHealingVial>(HealingVialClass, GetActorTransform(), SpawnParams);
+		if (!Vial)
+		{
+			continue;
+		}
+
+		Vial->ReturnToPool();
+		Vial->GetVialMesh()->SetStaticMesh(ThrownVialMesh);
+		Vial->GetVialMesh()->OnComponentHit.AddDynamic(this, &AMyProjectTest2Character::OnVialHit);
+		VialPool.Add(Vial);
+	}
+}
+
+AHealingVial* AMyProjectTest2Character::AcquireVial()
+{
+	if (VialPool.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	// Round robin from the oldest throw, so when every vial is still out the oldest one is taken back
+	for (int32 Offset = 0; Offset < VialPool.Num(); ++Offset)
+	{
+		const int32 Index = (NextVialIndex + Offset) % VialPool.Num();
+		if (IsValid(VialPool[Index]) && !VialPool[Index]->IsInUse())
+		{
+			NextVialIndex = Index + 1;
+			return VialPool[Index];
+		}
+	}
+
+	AHealingVial* Oldest = VialPool[NextVialIndex % VialPool.Num()];
+	++NextVialIndex;
+	return IsValid(Oldest) ? Oldest : nullptr;
 }
 
 void AMyProjectTest2Character::OnVialOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
@@ -2016,12 +1698,27 @@ void AMyProjectTest2Character::OnVialOverlap(UPrimitiveComponent* OverlappedComp
 	OnVialHit(OverlappedComponent, OtherActor, OtherComp, FVector::ZeroVector, SweepResult);
 }
 
-void AMyProjectTest2Character::EndVialSmashAnimation()
+void AMyProjectTest2Character::EndVialSmashAnimation(bool bWasCancelled)
 {
+	bIsSmashingVial = false;
+
+	if (bWasCancelled)
+	{
+		// Interrupted by a hit: the damage state owns movement now and there is no heal.
+		// A vial still in hand was never thrown, so put it away and allow another
+		if (HealingVialMesh && HealingVialMesh->IsVisible())
+		{
+			HealingVialMesh->SetVisibility(false);
+			SetVialAmbienceVisible(false);
+			bCanThrowVial = true;
+		}
+		UpdateWeaponVisibility();
+		return;
+	}
+
 	// Re-enable movement
 	GetCharacterMovement()->SetMovementMode(MOVE_Walking);
 	GetCharacterMovement()->MaxWalkSpeed = 500.f;
-	bIsSmashingVial = false;
 	AddHealth(30.0f);
 	// Restore weapon visibility based on previous state
 	UpdateWeaponVisibility();
@@ -2041,44 +1738,22 @@ void AMyProjectTest2Character::OnVialHit(UPrimitiveComponent* HitComponent, AAct
     {
         UE_LOG(LogTemp, Warning, TEXT("Vial hit detected with impulse: %f"), NormalImpulse.Size());
         
-        // Create a temporary light effect at the hit location
-        UPointLightComponent* HitLight = NewObject<UPointLightComponent>(this);
-        if (HitLight)
-        {
-            HitLight->SetWorldLocation(Hit.Location);
-            HitLight->SetLightColor(FColor(106.0f, 0.0f, 2.f));
-            HitLight->SetIntensity(1000.0f); // Flash on impact
-            HitLight->SetAttenuationRadius(150.0f);
-            HitLight->RegisterComponent();
-            
-            // Set up a timer to fade out the light
-            FTimerHandle FadeTimerHandle;
-            GetWorld()->GetTimerManager().SetTimer(
-                FadeTimerHandle,
-                [HitLight]()
-                {
-                    HitLight->DestroyComponent();
-                },
-                0.3f, // Short flash duration
-                false
-            );
-        }
-
     	if (GlassShatter)
     	{
-    		UNiagaraFunctionLibrary::SpawnSystemAtLocation(
-				GetWorld(),    // Get world context
+    		UCombatFXSubsystem::SpawnAtLocation(
+				this,          // World context
 				GlassShatter,  // Niagara system to spawn
 				Hit.Location,  // Location of the hit
 				Hit.ImpactNormal.Rotation(), // Rotation to align with surface
+				ECombatFXPriority::Impact,
 				FVector(0.3f) 
 			);
     	}
     	
-    	if (TempFallingVial)
+    	// The vial flashes its impact light where it broke, then goes back to the pool
+    	if (AHealingVial* Vial = HitComponent ? Cast<AHealingVial>(HitComponent->GetOwner()) : nullptr)
     	{
-    		TempFallingVial->DestroyComponent();
-    		TempFallingVial = nullptr;
+    		Vial->Shatter(Hit.Location);
     	}
     }
 
@@ -2089,51 +1764,21 @@ void AMyProjectTest2Character::ActivateHealingGlyph()
 {
 	if (HealingGlyphMesh && HealingGlyphLight)
 	{
-		// Make sure both are visible
 		HealingGlyphMesh->SetVisibility(true);
-		HealingGlyphLight->SetVisibility(true);
-        
-		// Set the light intensity
-		HealingGlyphLight->SetIntensity(5000.0f);
         
 		// Store the initial light intensity for fading
 		HealingGlyphInitialIntensity = 5000.0f;
-        
-		// Set up the glyph state
-		bIsHealingGlyphActive = true;
-		bIsHealingGlyphFading = false;
-		HealingGlyphTimer = 0.0f;
-		//HealingGlyphDuration = 0.5f;
-		//HealingGlyphFadeOutDuration = 1.0f;
-        
-		// Set up the timer for fade out
-		GetWorld()->GetTimerManager().ClearTimer(HealingGlyphTimerHandle);
-		GetWorld()->GetTimerManager().SetTimer(
-			HealingGlyphTimerHandle, 
-			this, 
-			&AMyProjectTest2Character::StartHealingGlyphFadeOut, 
-			HealingGlyphDuration, 
-			false);
-	}
-}
 
-void AMyProjectTest2Character::StartHealingGlyphFadeOut()
-{
-	if (bIsHealingGlyphActive && HealingGlyphLight && HealingGlyphMesh)
-	{
-		bIsHealingGlyphFading = true;
+		// Borrow a light shaped like the glyph's spot light; the manager holds and fades it with the glyph
+		UCombatLightSubsystem::ReleaseLight(this, HealingGlyphLightHandle, true);
+		FCombatLightRequest GlyphLight = FCombatLightRequest::FromTemplate(HealingGlyphLight, ECombatLightPriority::Critical);
+		GlyphLight.Intensity = HealingGlyphInitialIntensity;
+		GlyphLight.Duration = HealingGlyphDuration;
+		GlyphLight.FadeOut = HealingGlyphFadeOutDuration;
+		HealingGlyphLightHandle = UCombatLightSubsystem::RequestLight(this, GlyphLight);
         
-		// Set up a timer that will call a function to update the fade every frame
-		GetWorld()->GetTimerManager().ClearTimer(HealingGlyphTimerHandle);
-		GetWorld()->GetTimerManager().SetTimer(
-			HealingGlyphTimerHandle, 
-			this, 
-			&AMyProjectTest2Character::DeactivateHealingGlyph, 
-			HealingGlyphFadeOutDuration, 
-			false);
-            
-		// Start the fade out process
-		HealingGlyphTimer = 0.0f; // Reset for fade timing
+		// The glyph component holds, fades and hides it again
+		GlyphComponent->Show();
 	}
 }
 
@@ -2142,72 +1787,28 @@ void AMyProjectTest2Character::DeactivateHealingGlyph()
     if (HealingGlyphMesh && HealingGlyphLight)
     {
         HealingGlyphMesh->SetVisibility(false);
-        HealingGlyphLight->SetVisibility(false);
+        UCombatLightSubsystem::ReleaseLight(this, HealingGlyphLightHandle, true);
         bIsHealingGlyphActive = false;
         bIsHealingGlyphFading = false;
     }
 }
 
-void AMyProjectTest2Character::UpdateHealingGlyph(float DeltaTime)
+void AMyProjectTest2Character::SetVialAmbienceVisible(bool bVisible)
 {
-    if (!bIsHealingGlyphActive)
-        return;
-
-    // Rotate the glyph
-    if (HealingGlyphMesh)
-    {
-        FRotator NewRotation = HealingGlyphMesh->GetComponentRotation();
-        NewRotation.Yaw += GlyphRotationSpeed * DeltaTime;
-        HealingGlyphMesh->SetWorldRotation(NewRotation);
-    }
-
-    // Handle the intensity of both the glyph and light
-    HealingGlyphTimer += DeltaTime;
-
-    if (!bIsHealingGlyphFading && HealingGlyphTimer >= HealingGlyphDuration)
-    {
-        bIsHealingGlyphFading = true;
-        HealingGlyphTimer = 0.0f;
-    }
+	if (bVisible == VialAmbienceLightHandle.IsValid())
+	{
+		return;
+	}
 
-    if (bIsHealingGlyphFading)
-    {
-        // Calculate fade factor (1.0 to 0.0)
-        float FadeFactor = 1.0f - FMath::Clamp(HealingGlyphTimer / HealingGlyphFadeOutDuration, 0.0f, 1.0f);
-        
-        // Apply to both the mesh and light with the same fade factor
-        if (HealingGlyphMesh)
-        {
-            // For the mesh, we'll adjust opacity if it has a material that supports it
-            UMaterialInstanceDynamic* DynamicMaterial = nullptr;
-            if (!DynamicMaterial)
-            {
-                DynamicMaterial = UMaterialInstanceDynamic::Create(HealingGlyphMesh->GetMaterial(0), this);
-                HealingGlyphMesh->SetMaterial(0, DynamicMaterial);
-            }
-            
-            if (DynamicMaterial)
-            {
-                DynamicMaterial->SetScalarParameterValue(FName("Opacity"), FadeFactor);
-            }
-        }
-        
-        // Apply the same fade factor to the light intensity
-        if (HealingGlyphLight)
-        {
-            float CurrentIntensity = HealingGlyphInitialIntensity * FadeFactor;
-            HealingGlyphLight->SetIntensity(CurrentIntensity);
-            
-            // Make sure the light stays visible as long as the glyph is visible
-            HealingGlyphLight->SetVisibility(FadeFactor > 0.01f);
-        }
-        
-        // Deactivate everything when fully faded
-        if (HealingGlyphTimer >= HealingGlyphFadeOutDuration)
-        {
-            DeactivateHealingGlyph();
-        }
-    }
+	if (bVisible && HealingAmbientLight)
+	{
+		VialAmbienceLightHandle = UCombatLightSubsystem::RequestLight(this,
+			FCombatLightRequest::FromTemplate(HealingAmbientLight, ECombatLightPriority::Gameplay));
+	}
+	else
+	{
+		UCombatLightSubsystem::ReleaseLight(this, VialAmbienceLightHandle, true);
+	}
 }
 
 void AMyProjectTest2Character::QuickAttack()
@@ -2376,208 +1977,161 @@ void AMyProjectTest2Character::QuickAttack()
     	AimBlend = FMath::Clamp(ClampedPitch, 0.05f, 0.95f) * 100.0f;
     }
 
-    // Delay the actual shooting by 0.4 seconds
-    GetWorldTimerManager().SetTimer(
-        QuickAttackShootTimerHandle,
-        [this, OriginalMovementMode, OriginalMaxWalkSpeed]()
+    // Shoot 0.4 seconds in, drop into the fall pose at 0.6 and restore movement at 0.7
+    QuickAttackMove.Reset()
+        .Wait(0.4f)
+        .ContinueIf([this]() { return FireQuickAttackBolt(); })
+        .Wait(0.2f)
+        .Then([this]() { bInQuickAttackFall = true; })
+        .Wait(0.1f)
+        .Finally([this, OriginalMovementMode, OriginalMaxWalkSpeed](bool bWasCancelled)
         {
-            if (!ProjectileClass || !bCanShootArrow)
-            {
-                // Reset the quick attack state if we can't shoot
-                bInQuickAttack = false;
-                GetCharacterMovement()->SetMovementMode(OriginalMovementMode);
-                GetCharacterMovement()->MaxWalkSpeed = OriginalMaxWalkSpeed;
-                FollowCamera->SetRelativeLocation(DefaultCameraPosition);
-                FollowCamera->SetRelativeRotation(DefaultCameraRotation);
-                return;
-            }
-
-            // Set cooldown to prevent rapid firing
-            bCanShootArrow = false;
-            ArrowCooldownTimer = 0.0f;
-
-            // Get the socket transform from the left hand (where the bow is held)
-        	FTransform SocketTransform = GetMesh()->GetSocketTransform("CrossbowAimSocket", RTS_World);
-
-// Get the player controller
-APlayerController* PC = Cast<APlayerController>(GetController());
-if (!PC) return;
-
-// Get the viewport size
-int32 ViewportSizeX, ViewportSizeY;
-PC->GetViewportSize(ViewportSizeX, ViewportSizeY);
-
-// Calculate the center of the screen in screen space
-FVector2D ScreenCenter((ViewportSizeX * 0.5f), (ViewportSizeY * 0.5f) - 118.f);
-
-// Convert screen position to world position and direction
-FVector WorldLocation, WorldDirection;
-PC->DeprojectScreenPositionToWorld(ScreenCenter.X, ScreenCenter.Y, WorldLocation, WorldDirection);
+            // Re-enable movement explicitly
+            GetCharacterMovement()->SetMovementMode(OriginalMovementMode);
+            GetCharacterMovement()->MaxWalkSpeed = OriginalMaxWalkSpeed;
 
-// Perform a line trace to find what's under the crosshair
-FHitResult HitResult;
-FVector TraceStart = WorldLocation;
-FVector TraceEnd = WorldLocation + (WorldDirection * 10000.0f); // Trace far enough
+            // Reset camera to original position
+            FollowCamera->SetRelativeLocation(DefaultCameraPosition);
+            FollowCamera->SetRelativeRotation(DefaultCameraRotation);
 
-FCollisionQueryParams QueryParams;
-QueryParams.AddIgnoredActor(this); // Ignore self
+            bInQuickAttack = false;
+            bInQuickAttackFall = false;
 
-bool bHit = GetWorld()->LineTraceSingleByChannel(
-	HitResult,
-	TraceStart,
-	TraceEnd,
-	ECC_Visibility,
-	QueryParams
-);
+            if (bWasCancelled)
+            {
+                QuickAttackCurrentTime = QuickAttackTotalDuration;
+            }
+        });
+    QuickAttackMove.Start(this);
+    AimRigComponent->Wake();
+}
 
-// Calculate target point - use hit location if we hit something, otherwise use a point far in the distance
-FVector TargetPoint = bHit ? HitResult.Location : (WorldLocation + (WorldDirection * 5000.0f));
+bool AMyProjectTest2Character::FireQuickAttackBolt()
+{
+    if (!ProjectileClass || !bCanShootArrow)
+    {
+        // Ends the move, which restores movement and camera
+        return false;
+    }
 
-// Calculate direction from socket to target point
-FVector ShootDirection = (TargetPoint - SocketTransform.GetLocation()).GetSafeNormal();
+    // Set cooldown to prevent rapid firing
+    bCanShootArrow = false;
+    ArrowCooldownTimer = 0.0f;
 
-            // Spawn the projectile at the socket location
-            AProjectile_Arrow_Base* Projectile = GetWorld()->SpawnActor<AProjectile_Arrow_Base>(
-                ProjectileClass,
-                SocketTransform.GetLocation(),
-                ShootDirection.Rotation() // Set initial rotation to match shooting direction
-            );
+    // Get the socket transform from the left hand (where the bow is held)
+    FTransform SocketTransform = GetMesh()->GetSocketTransform("CrossbowAimSocket", RTS_World);
 
-            if (Projectile && !bIsInDamageState)
-            {
-            	CurrentProjectile = Projectile;
-            	
-            	Projectile->Scale(0.3);
-            	UGameplayStatics::PlaySoundAtLocation(
-					this,           // World context object
-					BowReleaseSound,// Sound to play
-					GetActorLocation(), // Location to play sound
-					1.0f,           // Volume multiplier
-					1.0f,           // Pitch multiplier
-					0.0f,           // Start time
-					nullptr,        // Attenuation settings
-					nullptr         // Concurrency settings
-				);
-            	Projectile->SetDamage(50.f);
-                if (Crossbow_arrows <= 0)
-                {
-                    GetWorldTimerManager().SetTimer(
-                        QuickAttackTimerHandle,
-                        [this, OriginalMovementMode, OriginalMaxWalkSpeed]()
-                        {
-                            // Re-enable movement explicitly
-                            GetCharacterMovement()->SetMovementMode(OriginalMovementMode);
-                            GetCharacterMovement()->MaxWalkSpeed = OriginalMaxWalkSpeed;
-
-                            // Reset camera to original position
-                            FollowCamera->SetRelativeLocation(DefaultCameraPosition);
-                            FollowCamera->SetRelativeRotation(DefaultCameraRotation);
-
-                            bInQuickAttack = false;
-                            bInQuickAttackFall = false;
-                        },
-                        0.7f, // Adjust this time as needed (0.5 seconds)
-                        false // Don't loop
-                    );
-
-                    // Set a timer to enable quick attack fall state after a small delay
-                    GetWorldTimerManager().SetTimer(
-                        QuickAttackFallTimerHandle,
-                        [this]()
-                        {
-                            bInQuickAttackFall = true;
-                        },
-                        0.6f, // Small delay before enabling fall state (adjust as needed)
-                        false // Don't loop
-                    );
-                    return; // Return if no arrows left
-                }
-                Crossbow_arrows--;
-            	LastCrossbowTime = 0.f;
-                // Set the velocity for the arrow
-                float ArrowSpeed = 2500.f;
-                FVector LaunchVelocity = ShootDirection * ArrowSpeed;
+    // Get the player controller
+    APlayerController* PC = Cast<APlayerController>(GetController());
+    if (!PC)
+    {
+        return false;
+    }
 
-                // Apply velocity to the projectile
-                Projectile->SetVelocity(LaunchVelocity);
+    // Get the viewport size
+    int32 ViewportSizeX, ViewportSizeY;
+    PC->GetViewportSize(ViewportSizeX, ViewportSizeY);
+
+    // Calculate the center of the screen in screen space
+    FVector2D ScreenCenter((ViewportSizeX * 0.5f), (ViewportSizeY * 0.5f) - 118.f);
+
+    // Convert screen position to world position and direction
+    FVector WorldLocation, WorldDirection;
+    PC->DeprojectScreenPositionToWorld(ScreenCenter.X, ScreenCenter.Y, WorldLocation, WorldDirection);
+
+    // Perform a line trace to find what's under the crosshair
+    FHitResult HitResult;
+    FVector TraceStart = WorldLocation;
+    FVector TraceEnd = WorldLocation + (WorldDirection * 10000.0f); // Trace far enough
+
+    FCollisionQueryParams QueryParams;
+    QueryParams.AddIgnoredActor(this); // Ignore self
+
+    bool bHit = GetWorld()->LineTraceSingleByChannel(
+        HitResult,
+        TraceStart,
+        TraceEnd,
+        ECC_Visibility,
+        QueryParams
+    );
 
-                // Set this character as the instigator (for damage attribution)
-                Projectile->SetInstigator(this);
+    // Calculate target point - use hit location if we hit something, otherwise use a point far in the distance
+    FVector TargetPoint = bHit ? HitResult.Location : (WorldLocation + (WorldDirection * 5000.0f));
 
-                // If the projectile has a mesh with physics enabled, apply impulse
-                if (Projectile->GetArrowMesh() && Projectile->GetArrowMesh()->IsSimulatingPhysics())
-                {
-                    Projectile->GetArrowMesh()->AddImpulse(LaunchVelocity, NAME_None, true);
-                }
+    // Calculate direction from socket to target point
+    FVector ShootDirection = (TargetPoint - SocketTransform.GetLocation()).GetSafeNormal();
 
-                // Apply a subtle backwards force to the character
-                FVector BackwardsForce = -GetActorForwardVector() * 300.0f; // Adjust force magnitude as needed
-                LaunchCharacter(BackwardsForce, false, false);
-            }
-        },
-        0.4f, // Delay the shot by 0.4 seconds
-        false // Don't loop
-    );
+    // Take a bolt from the pool at the socket location, rotated to match the shooting direction
+    UProjectilePoolSubsystem* ProjectilePool = UProjectilePoolSubsystem::Get(this);
+    AProjectile_Arrow_Base* Projectile = (ProjectilePool && !bIsInDamageState) ? ProjectilePool->Acquire(
+        ProjectileClass,
+        FTransform(ShootDirection.Rotation(), SocketTransform.GetLocation()),
+        this,
+        this
+    ) : nullptr;
 
-    // Set a timer to turn bInQuickAttack back to false after a short delay and restore movement
-    GetWorldTimerManager().SetTimer(
-        QuickAttackTimerHandle,
-        [this, OriginalMovementMode, OriginalMaxWalkSpeed]()
+    if (Projectile)
+    {
+        CurrentProjectile = Projectile;
+        CurrentProjectileGeneration = Projectile->GetPoolGeneration();
+
+        Projectile->Scale(0.3);
+        UCombatAudioSubsystem::PlayCue(
+            this,           // World context object
+            BowReleaseSound,// Sound to play
+            GetActorLocation(), // Location to play sound
+            ECombatAudioCategory::Weapon
+        );
+        Projectile->SetDamage(50.f);
+        if (Crossbow_arrows <= 0)
         {
-            // Re-enable movement explicitly
-            GetCharacterMovement()->SetMovementMode(OriginalMovementMode);
-            GetCharacterMovement()->MaxWalkSpeed = OriginalMaxWalkSpeed;
+            // No bolt left to launch, let the move play out its fall and restore
+            ProjectilePool->Release(Projectile);
+            CurrentProjectile.Reset();
+            return true;
+        }
+        Crossbow_arrows--;
+        InventoryComponent->Wake();
+        LastCrossbowTime = 0.f;
+        // Set the velocity for the arrow
+        float ArrowSpeed = 2500.f;
+        FVector LaunchVelocity = ShootDirection * ArrowSpeed;
 
-            // Reset camera to original position
-            FollowCamera->SetRelativeLocation(DefaultCameraPosition);
-            FollowCamera->SetRelativeRotation(DefaultCameraRotation);
+        // Apply velocity to the projectile
+        Projectile->SetVelocity(LaunchVelocity);
 
-            bInQuickAttack = false;
-            bInQuickAttackFall = false;
-        },
-        0.7f, // Adjust this time as needed (0.7 seconds)
-        false // Don't loop
-    );
+        // Set this character as the instigator (for damage attribution)
+        Projectile->SetInstigator(this);
 
-    // Set a timer to enable quick attack fall state after a small delay
-    GetWorldTimerManager().SetTimer(
-        QuickAttackFallTimerHandle,
-        [this]()
-        {
-            bInQuickAttackFall = true;
-        },
-        0.6f, // Small delay before enabling fall state (adjust as needed)
-        false // Don't loop
-    );
+        // Apply a subtle backwards force to the character
+        FVector BackwardsForce = -GetActorForwardVector() * 300.0f; // Adjust force magnitude as needed
+        LaunchCharacter(BackwardsForce, false, false);
+    }
+    return true;
 }
 
 void AMyProjectTest2Character::EnterDamageState(float StunDuration)
 {
+	// A hit interrupts the vial smash: no throw, no heal, and the stun keeps control of movement
+	VialSmashMove.Cancel();
 
 	if (bInQuickAttack)
 	{
-		// Cancel the quick attack if it's still in progress
-        bInQuickAttack = false;
-        GetCharacterMovement()->SetMovementMode(EMovementMode::MOVE_Walking);
-        GetCharacterMovement()->MaxWalkSpeed = 600.0f;
-        FollowCamera->SetRelativeLocation(DefaultCameraPosition);
-        FollowCamera->SetRelativeRotation(DefaultCameraRotation);
-
-		QuickAttackCurrentTime = QuickAttackTotalDuration;
+		// Cancel the quick attack if it's still in progress, which restores movement and camera
+		QuickAttackMove.Cancel();
 
-		// Destroy the projectile if it exists
-		if (CurrentProjectile)
+		// Take back the bolt if it's still the one we fired and still in flight; the pool may have handed it to someone else
+		AProjectile_Arrow_Base* Bolt = CurrentProjectile.Get();
+		if (Bolt && Bolt->GetPoolGeneration() == CurrentProjectileGeneration)
 		{
-			if (!CurrentProjectile->hasCollided)
+			UProjectilePoolSubsystem* ProjectilePool = UProjectilePoolSubsystem::Get(this);
+			if (!Bolt->hasCollided && ProjectilePool)
 			{
-				if (CurrentProjectile->Destroy())
-				{
-					Crossbow_arrows++;
-				}
+				ProjectilePool->Release(Bolt);
+				Crossbow_arrows++;
 			}
-			
-			CurrentProjectile = nullptr;
 		}
+		CurrentProjectile.Reset();
 	}
 	if (FMath::IsNearlyEqual(Health, 0.f, 0.5f))
 	{
@@ -2633,6 +2187,7 @@ void AMyProjectTest2Character::EnterDamageState(float StunDuration)
 void AMyProjectTest2Character::ExitDamageState()
 {
 	bIsInDamageState = false;
+	AimRigComponent->Wake();
 	if (GotKicked)
 	{
 		GotUp = false;
@@ -2670,6 +2225,7 @@ void AMyProjectTest2Character::PauseStaminaRegeneration()
 	bIsStaminaRegenPaused = true;
 	StaminaRegenPauseTimer = 0.0f;
 	StaminaRegenRate = BaseStaminaRegenRate; // Reset regen rate when paused
+	StaminaComponent->Wake();
 }
 // Add this new method to implement the restart functionality
 void AMyProjectTest2Character::RestartGame()
@@ -2741,27 +2297,19 @@ float AMyProjectTest2Character::KickDamage(float DamageAmount, FDamageEvent cons
 
 	if (!bIsDead)
 	{
-		UGameplayStatics::PlaySoundAtLocation(
+		UCombatAudioSubsystem::PlayCue(
 				this,           // World context object
 				TakeDamageSound,// Sound to play
 				GetActorLocation(), // Location to play sound
-				1.0f,           // Volume multiplier
-				1.0f,           // Pitch multiplier
-				0.0f,           // Start time
-				nullptr,        // Attenuation settings
-				nullptr         // Concurrency settings
+				ECombatAudioCategory::Player
 			);
 	}
 
-	UGameplayStatics::PlaySoundAtLocation(
+	UCombatAudioSubsystem::PlayCue(
 					this,           // World context object
 					FallSound,// Sound to play
 					GetActorLocation(), // Location to play sound
-					1.0f,           // Volume multiplier
-					1.0f,           // Pitch multiplier
-					0.0f,           // Start time
-					nullptr,        // Attenuation settings
-					nullptr         // Concurrency settings
+					ECombatAudioCategory::Player
 				);
 	
 	if (HitEffect) // Ensure effect is assigned
@@ -2786,11 +2334,12 @@ float AMyProjectTest2Character::KickDamage(float DamageAmount, FDamageEvent cons
 		}
         
 		// Spawn the effect at the hit location
-		UNiagaraFunctionLibrary::SpawnSystemAtLocation(
-			GetWorld(),    // Get world context
+		UCombatFXSubsystem::SpawnAtLocation(
+			this,          // World context
 			HitEffect,     // Niagara system to spawn
 			HitLocation,   // Location of the hit
-			HitRotation    // Rotation to align with surface
+			HitRotation,   // Rotation to align with surface
+			ECombatFXPriority::Critical
 		);
 	}
     
@@ -6,10 +6,20 @@
 #include "GameFramework/Character.h"
 #include "Logging/LogMacros.h"
 #include "NiagaraSystem.h"
+#include "CombatLightSubsystem.h"
+#include "CombatMove.h"
 #include "Projectile_Arrow_Base.h"
 #include "MyProjectTest2Character.generated.h"
 
 class AAI_Elite;
+class AHealingVial;
+class UPlayerAimRigComponent;
+class UPlayerAudioCueComponent;
+class UPlayerDodgeComponent;
+class UPlayerGlyphComponent;
+class UPlayerHUDViewModel;
+class UPlayerInventoryComponent;
+class UPlayerStaminaComponent;
 class USpringArmComponent;
 class UCameraComponent;
 class UInputMappingContext;
@@ -24,6 +34,17 @@ class AMyProjectTest2Character : public ACharacter
 {
 	GENERATED_BODY()
 
+	// On-demand components work directly on the character's state
+	friend class UPlayerAimRigComponent;
+	friend class UPlayerAudioCueComponent;
+	friend class UPlayerDodgeComponent;
+	friend class UPlayerGlyphComponent;
+	friend class UPlayerInventoryComponent;
+	friend class UPlayerStaminaComponent;
+#if WITH_DEV_AUTOMATION_TESTS
+	friend class FPlayerGlyphHealCycleAllocationTest;
+#endif
+
 	/** Camera boom positioning the camera behind the character */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	USpringArmComponent* CameraBoom;
@@ -139,31 +160,71 @@ class AMyProjectTest2Character : public ACharacter
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	UStaticMeshComponent* CrossBowOnBeltRef;
 	
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
+	UPlayerStaminaComponent* StaminaComponent;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
+	UPlayerInventoryComponent* InventoryComponent;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
+	UPlayerAudioCueComponent* AudioCueComponent;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
+	UPlayerGlyphComponent* GlyphComponent;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
+	UPlayerAimRigComponent* AimRigComponent;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (AllowPrivateAccess = "true"))
+	UPlayerDodgeComponent* DodgeComponent;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "UI", meta = (AllowPrivateAccess = "true"))
+	UPlayerHUDViewModel* HUDViewModel;
+	
 	UPROPERTY(EditDefaultsOnly, Category = "Healing")
 	float GlyphRotationSpeed = 90.0f; // Degrees per second
     
-	UPROPERTY()
-	FTimerHandle HealingGlyphTimerHandle;
-    
 	UPROPERTY()
 	bool bIsHealingGlyphActive = false;
 
+	// Lights borrowed from the combat light manager while the glyph or held vial is shown
+	FCombatLightHandle HealingGlyphLightHandle;
+	FCombatLightHandle VialAmbienceLightHandle;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Healing")
+	TSubclassOf<AHealingVial> HealingVialClass;
+	UPROPERTY(EditDefaultsOnly, Category = "Healing")
+	TSoftObjectPtr<UStaticMesh> FallbackVialMesh = TSoftObjectPtr<UStaticMesh>(FSoftObjectPath(TEXT("/Game/Meshes/SM_HealingVial.SM_HealingVial")));
+	UPROPERTY(EditDefaultsOnly, Category = "Healing")
+	int32 VialPoolSize = 3; // Thrown vials spawned at BeginPlay and reused
+
 	UPROPERTY()
-	UStaticMeshComponent* TempFallingVial;
+	UStaticMesh* ThrownVialMesh;
+	UPROPERTY()
+	TArray<AHealingVial*> VialPool;
+	int32 NextVialIndex = 0;
 	
 	UPROPERTY(EditDefaultsOnly, Category = "Combat")
 	UClass* ProjectileClass;
+	UPROPERTY(EditDefaultsOnly, Category = "Combat")
+	int32 ProjectilePoolPrewarm = 16; // Arrows spawned into the pool at BeginPlay
+	UPROPERTY(EditDefaultsOnly, Category = "Combat")
+	int32 BowVolleyCount = 1; // Arrows released per bow shot
+	UPROPERTY(EditDefaultsOnly, Category = "Combat")
+	float BowVolleySpread = 6.f; // Yaw in degrees between neighbouring arrows of a spread shot
+	UPROPERTY(EditDefaultsOnly, Category = "Combat")
+	float BowArrowDamage = 100.f;
 	FVector DefaultCameraPosition;
 	FRotator DefaultCameraRotation;
 	bool bCanAim = true;
 	FTimerHandle RagdollTimerHandle;
-	FTimerHandle QuickAttackTimerHandle;
-	FTimerHandle QuickAttackFallTimerHandle;
 	FTimerHandle ShootAnimationTimerHandle;
-	FTimerHandle VialSmashAnimationTimerHandle;
 	TEnumAsByte<enum EMovementMode> StoredMovementMode;
 	float StoredMaxWalkSpeed;
-	FTimerHandle VialThrowTimerHandle;
+
+	// Multi-stage moves; cancelling one runs its restore handler
+	FCombatMove QuickAttackMove;
+	FCombatMove VialSmashMove;
 	
 	UPROPERTY()
 	float HealingGlyphTimer = 0.0f;
@@ -184,10 +245,11 @@ class AMyProjectTest2Character : public ACharacter
 	float StaminaRegenPauseTimer = 0.f;
 	float StaminaRegenCooldown = 1.5;
 	UAudioComponent* WalkingSoundComponent;
-	float FootstepTimer;
+	int32 LastWeaponVisibilityKey = -1;
 	bool bHasPlayedBowAimSound;
 	class UAudioComponent* BowPullbackAudio;
-	AProjectile_Arrow_Base* CurrentProjectile = nullptr;
+	TWeakObjectPtr<AProjectile_Arrow_Base> CurrentProjectile; // Pooled, so only ours while the generation matches
+	uint32 CurrentProjectileGeneration = 0;
 	float FrameStartTime;
 	double FrameEndTime;
 	double FrameDuration;
@@ -196,7 +258,6 @@ class AMyProjectTest2Character : public ACharacter
 	int MaxHealVials = 3;
 	FTimerHandle GetUpTimerHandle;
 	float TimeInJudgementZone = 0.0f;
-	float HeartTimer = 0.0f;
 	FTimerHandle JumpCooldownTimerHandle;
 	bool bCanJump = true;
 	float LastRollTime;
@@ -206,6 +267,10 @@ class AMyProjectTest2Character : public ACharacter
 public:
 	AMyProjectTest2Character();
 
+	// What the bow fires, for tools that want to reproduce a real shot
+	UClass* GetProjectileClass() const { return ProjectileClass; }
+	float GetBowArrowDamage() const { return BowArrowDamage; }
+
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Animation")
 	bool bIsStrafing = false;
 	FVector MoveDirection;
@@ -234,7 +299,10 @@ public:
 	bool isJumping;
 
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Animation")
-	int JumpFrameCounter = 0;
+	int JumpFrameCounter = 0; // JumpTime counted in 60 Hz frames, for animation blueprints that still think in frames
+
+	UPROPERTY(BlueprintReadOnly, Category = "Animation")
+	float JumpTime = 0.f; // Seconds since the jump started
 
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Animation")
 	bool isCrouching = false;
@@ -292,6 +360,8 @@ public:
 	UPROPERTY(BlueprintReadWrite, Category = "Animation")
 	float AimTime;
 
+	float AimDrawRate = 9.f; // AimTime gained per second of drawing; the bow is drawn at 5
+
 	UPROPERTY(BlueprintReadWrite, Category = "Animation")
 	bool IsMovingForwad;
 
@@ -378,6 +448,9 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio")
 	USoundBase* WalkingSound;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio")
+	float FootstepStrideLength = 200.f; // Ground distance between footsteps
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio")
 	USoundBase* HeartSound;
 
@@ -435,7 +508,6 @@ protected:
 	void ShootBow();
 	void ResetShootAnimation();
 	void AimBow();
-	void RegenerateInventory(float DeltaTime);
 	bool FindNearestEliteBoss();
 	virtual void Tick(float DeltaTime) override;
 	void StopRolling();
@@ -469,17 +541,19 @@ protected:
 	void AddHealthInput(const FInputActionValue& Value);
 	void StartVialSmashAnimation();
 	void ThrowVial();
+	void PrewarmVials();
+	AHealingVial* AcquireVial();
 	void OnVialOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
 	                   int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
-	void EndVialSmashAnimation();
+	void EndVialSmashAnimation(bool bWasCancelled);
 	UFUNCTION() 
 	void OnVialHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
 	               FVector NormalImpulse, const FHitResult& Hit);
-	void StartHealingGlyphFadeOut();
 	void ActivateHealingGlyph();
+	void SetVialAmbienceVisible(bool bVisible);
 	void DeactivateHealingGlyph();
-	void UpdateHealingGlyph(float DeltaTime);
 	void QuickAttack();
+	bool FireQuickAttackBolt();
 	UFUNCTION()
 	void OnCapsuleOverlap(
 		UPrimitiveComponent* OverlappedComponent,
@@ -495,6 +569,7 @@ protected:
 	virtual float TakeDamage(float DamageAmount, const struct FDamageEvent& DamageEvent,
 	                         class AController* EventInstigator, AActor* DamageCauser) override;
 	float GetDisplayHealth() const;
+	void PushHUDState();
 	void HandleDeath();
 	void CheckForMeleeHits();
 
@@ -503,6 +578,9 @@ public:
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	/** Returns FollowCamera subobject **/
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
+	/** What the HUD shows; the character pushes into it at the end of every tick **/
+	UFUNCTION(BlueprintPure, Category = "UI")
+	UPlayerHUDViewModel* GetHUDViewModel() const { return HUDViewModel; }
 
 	void EnterDamageState(float StunDuration);
 	void ExitDamageState();
@@ -546,11 +624,11 @@ private:
 	bool WasCrouching = false;
 	bool WasSprinting = false;
 
-	int JumpCooldown = 58;
-	int FramesSinceLastJump = 0;
+	float JumpCooldown = 58.f / 60.f; // Seconds
+	float TimeSinceLastJump = 0.f;
 
 	float JumpCost = 20.f;
-	float SprintCost = .5f;
+	float SprintCost = 30.f; // Stamina per second
 	float RollCost = 15.f;
 
 	int StaminaZeroFrame = 0;
@@ -559,6 +637,5 @@ private:
 	float LastHealthAddTime = 0.0f;
 	float HealthAddCooldown = 0.3f;
 	FTimerHandle DamageStateTimerHandle;
-	FTimerHandle QuickAttackShootTimerHandle;
 
 };
@@ -11,6 +11,14 @@
 #include "NiagaraFunctionLibrary.h"
 #include "NiagaraSystem.h"
 #include "Camera/CameraComponent.h"
+#include "CombatFrameSubsystem.h"
+#include "CombatAudioSubsystem.h"
+#include "CombatFlowFieldSubsystem.h"
+#include "CombatFXSubsystem.h"
+#include "CombatNavigationSubsystem.h"
+#include "Curves/CurveFloat.h"
+#include "EnemyHealthBarSubsystem.h"
+#include "FootstepSubsystem.h"
 #include "MyProjectTest2/CPP_Repo/MyProjectTest2Character.h"
 class AMyProjectTest2Character;
 // Sets default values
@@ -48,18 +56,16 @@ void AAI_Character::BeginPlay()
     Super::BeginPlay();
     TargetHealth = 100.f;
     
-    // Find the health bar widget component
-    HealthBarWidget = Cast<UWidgetComponent>(GetComponentByClass(UWidgetComponent::StaticClass()));
-    if (HealthBarWidget)
+    // Health bars are drawn in one pass by UEnemyHealthBarSubsystem; drop the blueprint's old per-grunt widget.
+    // HealthBarWidget is bound the way it always was and only that component goes, any other widget stays
+    if (!HealthBarWidget)
     {
-        HealthBarWidget->SetWidgetSpace(EWidgetSpace::Screen);
-        HealthBarWidget->SetDrawSize(FVector2D(100.0f, 15.0f));
-        HealthBarWidget->SetRelativeLocation(FVector(0.0f, 0.0f, 200.0f)); // Position above the character
-        HealthBarWidget->SetVisibility(false); // Initially hidden
+        HealthBarWidget = Cast<UWidgetComponent>(GetComponentByClass(UWidgetComponent::StaticClass()));
     }
-    else
+    if (HealthBarWidget)
     {
-        UE_LOG(LogTemp, Warning, TEXT("HealthBarWidget not found!"));
+        HealthBarWidget->DestroyComponent();
+        HealthBarWidget = nullptr;
     }
 
     // Set up collision for AI avoidance with stronger settings
@@ -135,6 +141,47 @@ void AAI_Character::BeginPlay()
 
 	//UCameraComponent* CameraRef = FindComponentByClass<UCameraComponent>();
 	CameraRef = FindComponentByClass<UCameraComponent>();
+
+	if (UCombatFrameSubsystem* CombatFrame = UCombatFrameSubsystem::Get(this))
+	{
+		CombatFrame->RegisterEnemy(this);
+		CombatFrame->AddStageWork(ECombatFrameStage::GatherSnapshot, this,
+			[this](const FCombatSnapshot&, float) { GatherPerceptionInputs(); });
+		CombatFrame->AddStageWork(ECombatFrameStage::Perception, this,
+			[this](const FCombatSnapshot& Snapshot, float) { UpdatePerception(Snapshot); }, true);
+		// Decisions read live combat state (stun, attacks, health), so they stay on the game thread
+		CombatFrame->AddStageWork(ECombatFrameStage::Decisions, this,
+			[this](const FCombatSnapshot& Snapshot, float) { UpdateCombatDecision(Snapshot); });
+		CombatFrame->AddStageWork(ECombatFrameStage::MovementRequests, this,
+			[this](const FCombatSnapshot& Snapshot, float) { ApplyCombatIntent(Snapshot); });
+	}
+
+	if (UFootstepSubsystem* Footsteps = UFootstepSubsystem::Get(this))
+	{
+		FFootstepSettings FootstepSettings;
+		FootstepSettings.Sound = WalkingSound;
+		FootstepSettings.StrideLength = FootstepStrideLength;
+		FootstepSettings.Volume = 0.4f;
+		FootstepSettings.bCanJoinCrowd = true;
+		Footsteps->Register(this, MoveTemp(FootstepSettings));
+		Footsteps->SetCrowdLoop(CrowdFootstepLoop);
+	}
+}
+
+void AAI_Character::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UCombatFrameSubsystem* CombatFrame = UCombatFrameSubsystem::Get(this))
+	{
+		CombatFrame->RemoveStageWork(this);
+		CombatFrame->UnregisterEnemy(this);
+	}
+
+	if (UFootstepSubsystem* Footsteps = UFootstepSubsystem::Get(this))
+	{
+		Footsteps->Unregister(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AAI_Character::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -184,8 +231,6 @@ void AAI_Character::OnMovementUpdated(float DeltaSeconds, const FVector& OldLoca
 // Called every frame
 void AAI_Character::Tick(float DeltaTime)
 {
-	UpdateHealthLerp();
-
 	if (bIsJumping)
 	{
 		// Apply gravity while jumping
@@ -200,229 +245,186 @@ void AAI_Character::Tick(float DeltaTime)
 		}
 	}
 	
-	if (!bIsHealthLerping && bIsDead)
+	// Check if the AI is dead; the health bar layer finishes draining its bar without us
+	if (bIsDead)
 	{
-		HealthBarWidget->SetVisibility(false);
+		return;
 	}
 
-	// Check if the AI is dead
-	if (bIsDead)
+	Super::Tick(DeltaTime);
+
+	// Perception, decisions and move requests run as stages of the combat frame (see UCombatFrameSubsystem)
+
+	if (bIsInDamageState)
 	{
-		// Don't hide health bar here - we'll hide it after the lerp is complete in UpdateHealthLerp
-		// Only return if we're not lerping health anymore
-		if (!bIsHealthLerping)
-		{
-			return;
-		}
+		// Stop movement if currently moving
+		UCombatNavigationSubsystem::StopMovement(Cast<AAIController>(GetController()));
+		return;
 	}
 
-	// Show health bar if health is not full
-	if (CurrentHealth < 100.0f)
+	// Flow field steering is chosen per sim step but movement needs input every frame
+	if (!FlowFieldDirection.IsZero())
 	{
-		HealthBarWidget->SetVisibility(true);
+		AddMovementInput(FlowFieldDirection);
 	}
-	
-	Super::Tick(DeltaTime);
+}
 
-	// UCameraComponent* Camera;
-	// AAIController* AIController = Cast<AAIController>(GetController());
-	// if (AIController)
-	// {
-	// 	Camera = AIController->GetPawn()->FindComponentByClass<UCameraComponent>();
-	// }
-	
-    if (TargetHealth > 0.0f || bIsHealthLerping)
-    {
-        // Get the player's pawn (assuming player index 0)
-        APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
-        if (!PlayerPawn)
-        {
-            return;
-        }
-    
-    		// Get direction from health bar to player
-    		FVector PlayerLocation = PlayerPawn->GetActorLocation();
-    		FVector WidgetLocation = HealthBarWidget->GetComponentLocation();
-    		FVector Direction = PlayerLocation - WidgetLocation;
-    		Direction.Normalize();
-            
-    		// Convert to rotation
-    		FRotator LookAtRotation = Direction.Rotation();
-    	
-    		// We only want to rotate on the yaw axis (around Z)
-    		// This keeps the health bar upright while facing the player
-    		HealthBarWidget->SetWorldRotation(FRotator(0, LookAtRotation.Yaw + 180.0f, 0));
-    	
-
-        // Get AI Controller
-        AAIController* AIController = Cast<AAIController>(GetController());
-        if (!AIController)
-        {
-            UE_LOG(LogTemp, Warning, TEXT("AIController not found!"));
-            return;
-        }
+void AAI_Character::GatherPerceptionInputs()
+{
+	// Component transforms are only safe to read on the game thread, so cache them for the perception stage
+	bPerceptionActive = (TargetHealth > 0.0f || bIsHealthLerping) && !(bIsDead && !bIsHealthLerping) && CameraRef && GetController();
+	if (!bPerceptionActive)
+	{
+		return;
+	}
 
-        // Get the distance to the player
-        float DistanceToPlayer = FVector::Dist(GetActorLocation(), PlayerPawn->GetActorLocation());
+	PerceptionEyeLocation = CameraRef->GetComponentLocation();
+	PerceptionEyeRotation = CameraRef->GetComponentRotation();
+	PerceptionFOV = CameraRef->FieldOfView;
+	PerceptionLocation = GetActorLocation();
+}
 
-        // Define the detection and stopping distances
-        constexpr float DetectionRadius = 1600.0f; // AI notices player within this range
-        constexpr float StopRadius = 100.0f; // AI stops moving if within this range
+void AAI_Character::UpdatePerception(const FCombatSnapshot& Snapshot)
+{
+	// Once the player has been found we never lose them, so the ray fan is only needed until then
+	if (!bPerceptionActive || bHasFoundPlayer || !Snapshot.PlayerRaw)
+	{
+		return;
+	}
 
-    	// Get camera location and rotation
-    	FVector CameraLocation = CameraRef->GetComponentLocation();
-    	FRotator CameraRotation = CameraRef->GetComponentRotation();
+	// Define the detection distance
+	constexpr float DetectionRadius = 1600.0f; // AI notices player within this range
 
-    	// Define the FOV parameters
-    	float FOVAngle = CameraRef->FieldOfView; // In degrees
-    	float HalfFOVAngle = FOVAngle * 1.5f; // Half of the FOV angle
+	// A moving player is heard within the detection radius
+	if (FVector::Dist(PerceptionLocation, Snapshot.PlayerLocation) <= DetectionRadius && Snapshot.PlayerSpeed > 300.f)
+	{
+		bHasFoundPlayer = true;
+		return;
+	}
 
-    	// Calculate the number of rays to cast within the FOV
-    	int NumRays = 1000; // Adjust this value to control the density of rays
+	// Define the FOV parameters
+	float FOVAngle = PerceptionFOV; // In degrees
+	float HalfFOVAngle = FOVAngle * 1.5f; // Half of the FOV angle
 
-    	// Calculate the angle between each ray
-    	float AngleBetweenRays = FOVAngle / (NumRays - 1);
+	// Calculate the number of rays to cast within the FOV
+	int NumRays = 1000; // Adjust this value to control the density of rays
 
-    	// Perform ray tracing for each ray within the FOV
-    	for (int i = 0; i < NumRays; i++)
-    	{
-    		// Calculate the angle for the current ray
-    		float CurrentAngle = -HalfFOVAngle + (i * AngleBetweenRays);
+	// Calculate the angle between each ray
+	float AngleBetweenRays = FOVAngle / (NumRays - 1);
 
-    		// Convert the angle to a rotation
-    		FRotator RayRotation = CameraRotation;
-    		RayRotation = FRotator(CameraRotation.Pitch, CameraRotation.Yaw + CurrentAngle, CameraRotation.Roll);
+	// Perform ray tracing for each ray within the FOV
+	FCollisionQueryParams QueryParams;
+	for (int i = 0; i < NumRays; i++)
+	{
+		// Calculate the angle for the current ray
+		float CurrentAngle = -HalfFOVAngle + (i * AngleBetweenRays);
 
+		// Convert the angle to a rotation
+		FRotator RayRotation(PerceptionEyeRotation.Pitch, PerceptionEyeRotation.Yaw + CurrentAngle, PerceptionEyeRotation.Roll);
 
-    		// Calculate the end location of the ray
-    		FVector RayEndLocation = CameraLocation + (RayRotation.Vector() * 5000.0f); // Adjust this value to control the ray length
+		// Calculate the end location of the ray
+		FVector RayEndLocation = PerceptionEyeLocation + (RayRotation.Vector() * 5000.0f); // Adjust this value to control the ray length
 
-    		// Perform the line trace
-    		FCollisionQueryParams QueryParams;
-    		FHitResult HitResult;
-    		if (GetWorld()->LineTraceSingleByChannel(HitResult, CameraLocation, RayEndLocation, ECC_Pawn, QueryParams))
-    		{
-    			// If the line trace hits the player's pawn, the AI can see the player
-    			if (HitResult.GetActor() == PlayerPawn)
-    			{
-    				bHasFoundPlayer = true;
-    			}
-    		}
-    	}
+		// Perform the line trace
+		FHitResult HitResult;
+		if (GetWorld()->LineTraceSingleByChannel(HitResult, PerceptionEyeLocation, RayEndLocation, ECC_Pawn, QueryParams))
+		{
+			// If the line trace hits the player's pawn, the AI can see the player
+			if (HitResult.GetActor() == Snapshot.PlayerRaw)
+			{
+				bHasFoundPlayer = true;
+				return;
+			}
+		}
+	}
+}
 
+void AAI_Character::UpdateCombatDecision(const FCombatSnapshot& Snapshot)
+{
+	CombatIntent = ECombatIntent::None;
 
-    	
-        if (DistanceToPlayer <= DetectionRadius)
-        {
-        	AMyProjectTest2Character* MyPlayerCharacter = Cast<AMyProjectTest2Character>(PlayerPawn);
-        	if (MyPlayerCharacter->CachedSpeed > 300.f)
-        	{
-        		bHasFoundPlayer = true;
-        	}
-        		
-            
-        }
-    	
-        // Don't process AI behavior if in damage state (stunned)
-        if (bIsInDamageState)
-        {
-            return;
-        }
-    	
-    	if (HealthBarWidget && PlayerPawn)
-    	{
-    		//float DistanceToPlayer = FVector::Dist(GetActorLocation(), PlayerPawn->GetActorLocation());
-            
-    		// Define min and max distances for scaling
-    		const float MinDistance = 200.0f;  // Distance at which health bar is at max size
-    		const float MaxDistance = 2000.0f; // Distance at which health bar is at min size
-            
-    		// Define min and max scale factors
-    		const float MinScale = 0.5f;  // Minimum scale when far away
-    		const float MaxScale = 1.0f;  // Maximum scale when close
-            
-    		// Calculate scale factor based on distance (clamped between min and max scale)
-    		float ScaleFactor = FMath::GetMappedRangeValueClamped(
-				FVector2D(MinDistance, MaxDistance),
-				FVector2D(MaxScale, MinScale),
-				DistanceToPlayer
-			);
-            
-    		// Apply scale to health bar widget
-    		FVector2D BaseSize(100.0f, 15.0f);  // Your original size
-    		HealthBarWidget->SetDrawSize(BaseSize * ScaleFactor);
-    	}
-
-
-    	if (bHasFoundPlayer)
-    	{
-    		if (DistanceToPlayer > StopRadius)
-    		{
-    			// Only move if not currently executing an attack
-    			if (!bIsExecutingAttack && !bIsInDamageState)
-    			{
-    				if (!bIsDead && TargetHealth > 0.0f)
-    				{
-    					// Use AI avoidance when moving to player
-    					FPathFindingQuery PathFindingQuery;
-    					FAIMoveRequest MoveRequest;
-    					MoveRequest.SetGoalActor(PlayerPawn);
-    					MoveRequest.SetAcceptanceRadius(5.0f);
-    					MoveRequest.SetUsePathfinding(true);
-                
-    					AIController->MoveToActor(PlayerPawn, 5.0f, true, true, false, nullptr, true);
-    					IsAttacking = false; // Ensure attack state is reset when moving
-    				}
-    			}
-    		}
-            else
-            {
-                AIController->StopMovement();
-
-                // Check if within attack range
-                if (DistanceToPlayer <= AttackRange)
-                {
-                    // Only start a new attack if not already attacking and cooldown has expired
-                    if (bCanAttack && !bIsExecutingAttack)
-                    {
-                    	if (!bIsDead)
-                    	{
-                    		// Perform the attack
-                    		AttackPlayer(PlayerPawn, AIController);
-                    		IsAttacking = true;
-                    	}
-                    }
-                }
-                else
-                {
-                    // Only reset attack state if we're not in the middle of an attack
-                    if (!bIsExecutingAttack)
-                    {
-                        IsAttacking = false;
-                    }
-                	if (!bIsInDamageState)
-                	{
-                		AIController->MoveToActor(PlayerPawn, 5.0f, true, true, true, nullptr, true);
-                	}
-                }
-            }
-        }
-    	
-    }
+	// Don't process AI behavior if in damage state (stunned)
+	if (!bPerceptionActive || !bHasFoundPlayer || bIsDead || bIsInDamageState || !Snapshot.PlayerRaw)
+	{
+		return;
+	}
 
-	if (bIsInDamageState)
+	constexpr float StopRadius = 100.0f; // AI stops moving if within this range
+	const float DistanceToPlayer = FVector::Dist(PerceptionLocation, Snapshot.PlayerLocation);
+
+	if (DistanceToPlayer > StopRadius)
 	{
-		// Stop movement if currently moving
-		AAIController* AIController = Cast<AAIController>(GetController());
-		if (AIController)
+		// Only move if not currently executing an attack
+		if (!bIsExecutingAttack && TargetHealth > 0.0f)
 		{
-			AIController->StopMovement();
+			CombatIntent = ECombatIntent::Chase;
 		}
+	}
+	else
+	{
+		CombatIntent = DistanceToPlayer <= AttackRange ? ECombatIntent::Attack : ECombatIntent::Close;
+	}
+}
+
+void AAI_Character::ApplyCombatIntent(const FCombatSnapshot& Snapshot)
+{
+	APawn* PlayerPawn = Snapshot.Player.Get();
+	AAIController* AIController = Cast<AAIController>(GetController());
+
+	// Leaving the flow field hands the focus back to path following, or to nothing
+	if (!FlowFieldDirection.IsZero() && AIController && CombatIntent != ECombatIntent::Chase)
+	{
+		AIController->ClearFocus(EAIFocusPriority::Move);
+	}
+	FlowFieldDirection = FVector::ZeroVector;
+
+	if (CombatIntent == ECombatIntent::None || !PlayerPawn || !AIController)
+	{
 		return;
 	}
 
-}
+	switch (CombatIntent)
+	{
+	case ECombatIntent::Chase:
+	{
+		// Steer down the shared flow field; only grunts it can't guide (e.g. close to the player) path on their own.
+		// Either way RVO avoidance keeps the crowd apart
+		UCombatFlowFieldSubsystem* FlowField = UCombatFlowFieldSubsystem::Get(this);
+		if (FlowField && FlowField->SampleDirection(GetActorLocation(), FlowFieldDirection))
+		{
+			UCombatNavigationSubsystem::StopMovement(AIController);
+			AIController->SetFocalPoint(GetActorLocation() + FlowFieldDirection * 100.f, EAIFocusPriority::Move);
+		}
+		else
+		{
+			UCombatNavigationSubsystem::MoveToActor(AIController, PlayerPawn);
+		}
+		IsAttacking = false; // Ensure attack state is reset when moving
+		break;
+	}
+	case ECombatIntent::Attack:
+		UCombatNavigationSubsystem::StopMovement(AIController);
 
+		// Only start a new attack if not already attacking and cooldown has expired
+		if (bCanAttack && !bIsExecutingAttack)
+		{
+			// Perform the attack
+			AttackPlayer(PlayerPawn, AIController);
+			IsAttacking = true;
+		}
+		break;
+	case ECombatIntent::Close:
+		// Only reset attack state if we're not in the middle of an attack
+		if (!bIsExecutingAttack)
+		{
+			IsAttacking = false;
+		}
+		UCombatNavigationSubsystem::MoveToActor(AIController, PlayerPawn, 5.0f, true);
+		break;
+	default:
+		break;
+	}
+}
 
 void AAI_Character::AttackPlayer(APawn* PlayerPawn, AAIController* AIController)
 {
@@ -534,22 +536,15 @@ float AAI_Character::TakeDamage(float DamageAmount, FDamageEvent const& DamageEv
 			PlayerCharacter->AddHealth(1.0f);
 		}
 	}
-	AAIController* AIController = Cast<AAIController>(GetController());
-	if (AIController)
-	{
-		AIController->StopMovement();
-	}
+	UCombatNavigationSubsystem::StopMovement(Cast<AAIController>(GetController()));
 	bIsInDamageState = true;
     float ActualDamage = Super::TakeDamage(DamageAmount, DamageEvent, EventInstigator, DamageCauser);
-	UGameplayStatics::PlaySoundAtLocation(
+	UCombatAudioSubsystem::PlayCue(
 			this,           // World context object
 			TakeDamageSound,// Sound to play
 			GetActorLocation(), // Location to play sound
-			0.4f,           // Volume multiplier
-			1.0f,           // Pitch multiplier
-			0.0f,           // Start time
-			nullptr,        // Attenuation settings
-			nullptr         // Concurrency settings
+			ECombatAudioCategory::Damage,
+			0.4f            // Volume multiplier
 		);
 	if (HitEffect) // Ensure effect is assigned
 	{
@@ -573,11 +568,12 @@ float AAI_Character::TakeDamage(float DamageAmount, FDamageEvent const& DamageEv
 		}
         
 		// Spawn the effect at the hit location
-		UNiagaraFunctionLibrary::SpawnSystemAtLocation(
-			GetWorld(),    // Get world context
+		UCombatFXSubsystem::SpawnAtLocation(
+			this,          // World context
 			HitEffect,     // Niagara system to spawn
 			HitLocation,   // Location of the hit
-			HitRotation    // Rotation to align with surface
+			HitRotation,   // Rotation to align with surface
+			ECombatFXPriority::Impact
 		);
 	}
     
@@ -586,7 +582,7 @@ float AAI_Character::TakeDamage(float DamageAmount, FDamageEvent const& DamageEv
         // Update health
         Health = FMath::Clamp(Health - ActualDamage, 0.0f, MaxHealth);
         TargetHealth = Health;
-        bIsHealthLerping = true;
+        StartHealthLerp();
         
         // Check for death
         if (Health <= 0.0f)
@@ -651,43 +647,43 @@ float AAI_Character::TakeDamage(float DamageAmount, FDamageEvent const& DamageEv
     return ActualDamage;
 }
 
-void AAI_Character::UpdateHealthLerp()
+void AAI_Character::StartHealthLerp()
 {
-
-	if (FMath::Abs(CurrentHealth - TargetHealth) > 75.0f)
-	{
-		ErrorTolerance = 0.1f; // Increase tolerance for large health changes
-	}
-	else
+	// Start from wherever the bar is now, so a hit mid-drain continues smoothly
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (bIsHealthLerping)
 	{
-		ErrorTolerance = 5.f; // Default tolerance for small health changes
+		UpdateHealthLerp(Now);
 	}
+	HealthLerpFromHealth = CurrentHealth;
+	HealthLerpStartTime = Now;
+	bIsHealthLerping = true;
 
-	float lerpSpeed = 0.02f; // Default lerp speed
-    
-	// If the health difference is large, use a slower lerp speed
-	if (FMath::Abs(CurrentHealth - TargetHealth) > 50.0f)
+	if (UEnemyHealthBarSubsystem* HealthBars = UEnemyHealthBarSubsystem::Get(this))
 	{
-		lerpSpeed = 0.01f; // Slower lerp for big health changes
+		HealthBars->AddDrain(this);
 	}
-
-	// Directly lerp between CurrentHealth and TargetHealth without using time-based calculation
-	CurrentHealth = FMath::Lerp(CurrentHealth, TargetHealth, lerpSpeed);
-	
-
-	// You can adjust the 0.1f value to control the lerp speed. The closer to 1.0, the faster it interpolates.
-	
-	// Stop lerping if we're "close enough"
-	if (FMath::IsNearlyEqual(CurrentHealth, TargetHealth, ErrorTolerance)) 
+	else
 	{
+		// Nothing draws the bar, so nothing would finish the drain
 		CurrentHealth = TargetHealth;
 		bIsHealthLerping = false;
-		//GetWorldTimerManager().ClearTimer(HealthLerpTimerHandle);
 	}
-	else
+}
+
+bool AAI_Character::UpdateHealthLerp(double Now)
+{
+	const float Alpha = HealthLerpDuration > 0.f ? FMath::Clamp(static_cast<float>((Now - HealthLerpStartTime) / HealthLerpDuration), 0.f, 1.f) : 1.f;
+	if (Alpha >= 1.f)
 	{
-		bIsHealthLerping = true;
+		CurrentHealth = TargetHealth;
+		bIsHealthLerping = false;
+		return false;
 	}
+
+	const float Progress = HealthLerpCurve ? HealthLerpCurve->GetFloatValue(Alpha) : FMath::InterpEaseOut(0.f, 1.f, Alpha, 2.f);
+	CurrentHealth = FMath::Lerp(HealthLerpFromHealth, TargetHealth, Progress);
+	return true;
 }
 
 void AAI_Character::ExitDamageState()
@@ -711,15 +707,12 @@ void AAI_Character::EnableRagdoll()
 		PlayerCharacter->AddHealth(15.0f);
 	}
 
-	UGameplayStatics::PlaySoundAtLocation(
+	UCombatAudioSubsystem::PlayCue(
 			this,           // World context object
 			DeathSound,// Sound to play
 			GetActorLocation(), // Location to play sound
-			0.4f,          // Volume multiplier
-			1.0f,           // Pitch multiplier
-			0.0f,           // Start time
-			nullptr,        // Attenuation settings
-			nullptr         // Concurrency settings
+			ECombatAudioCategory::Death,
+			0.4f            // Volume multiplier
 		);
     // Get the mesh component
     USkeletalMeshComponent* MeshComp = GetMesh();
@@ -780,22 +773,15 @@ float AAI_Character::GetKicked(float DamageAmount, FDamageEvent const& DamageEve
 			PlayerCharacter->AddHealth(1.0f);
 		}
 	}
-	AAIController* AIController = Cast<AAIController>(GetController());
-	if (AIController)
-	{
-		AIController->StopMovement();
-	}
+	UCombatNavigationSubsystem::StopMovement(Cast<AAIController>(GetController()));
 	bIsInDamageState = true;
     float ActualDamage = Super::TakeDamage(DamageAmount, DamageEvent, EventInstigator, DamageCauser);
-	UGameplayStatics::PlaySoundAtLocation(
+	UCombatAudioSubsystem::PlayCue(
 			this,           // World context object
 			TakeDamageSound,// Sound to play
 			GetActorLocation(), // Location to play sound
-			0.4f,           // Volume multiplier
-			1.0f,           // Pitch multiplier
-			0.0f,           // Start time
-			nullptr,        // Attenuation settings
-			nullptr         // Concurrency settings
+			ECombatAudioCategory::Damage,
+			0.4f            // Volume multiplier
 		);
 	if (HitEffect) // Ensure effect is assigned
 	{
@@ -819,11 +805,12 @@ float AAI_Character::GetKicked(float DamageAmount, FDamageEvent const& DamageEve
 		}
         
 		// Spawn the effect at the hit location
-		UNiagaraFunctionLibrary::SpawnSystemAtLocation(
-			GetWorld(),    // Get world context
+		UCombatFXSubsystem::SpawnAtLocation(
+			this,          // World context
 			HitEffect,     // Niagara system to spawn
 			HitLocation,   // Location of the hit
-			HitRotation    // Rotation to align with surface
+			HitRotation,   // Rotation to align with surface
+			ECombatFXPriority::Impact
 		);
 	}
     
@@ -832,7 +819,7 @@ float AAI_Character::GetKicked(float DamageAmount, FDamageEvent const& DamageEve
         // Update health
         Health = FMath::Clamp(Health - ActualDamage, 0.0f, MaxHealth);
         TargetHealth = Health;
-        bIsHealthLerping = true;
+        StartHealthLerp();
         
         // Check for death
         if (Health <= 0.0f)
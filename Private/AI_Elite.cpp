@@ -10,6 +10,10 @@
 #include "NavigationSystem.h"
 #include "NiagaraFunctionLibrary.h"
 #include "Camera/CameraComponent.h"
+#include "CombatFrameSubsystem.h"
+#include "CombatAudioSubsystem.h"
+#include "CombatFXSubsystem.h"
+#include "CombatNavigationSubsystem.h"
 #include "Components/CapsuleComponent.h"
 #include "Engine/DamageEvents.h"
 #include "GameFramework/CharacterMovementComponent.h"
@@ -48,7 +52,7 @@ void AAI_Elite::BeginPlay()
 	PlayerPawn = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
 
 	if (PlayerPawn != nullptr) {
-		GetController<AAIController>()->MoveToActor(PlayerPawn, 5.0f, true, true, false, nullptr, true);
+		UCombatNavigationSubsystem::MoveToActor(GetController<AAIController>(), PlayerPawn);
 	}
 	
     UCapsuleComponent* CapsuleComp = GetCapsuleComponent();
@@ -127,6 +131,28 @@ void AAI_Elite::BeginPlay()
 	RingMesh = Cast<UStaticMeshComponent>(GetDefaultSubobjectByName(TEXT("Ring")));
 	DomeMesh = Cast<UStaticMeshComponent>(GetDefaultSubobjectByName(TEXT("Dome")));
 	// Move AI to a specific location when the game starts (exathe mple)
+
+	if (UCombatFrameSubsystem* CombatFrame = UCombatFrameSubsystem::Get(this))
+	{
+		CombatFrame->RegisterEnemy(this);
+		CombatFrame->AddStageWork(ECombatFrameStage::GatherSnapshot, this,
+			[this](const FCombatSnapshot&, float) { GatherPerceptionInputs(); });
+		CombatFrame->AddStageWork(ECombatFrameStage::Perception, this,
+			[this](const FCombatSnapshot& Snapshot, float) { UpdatePerception(Snapshot); }, true);
+		CombatFrame->AddStageWork(ECombatFrameStage::Decisions, this,
+			[this](const FCombatSnapshot& Snapshot, float) { UpdateCombatDecision(Snapshot); });
+	}
+}
+
+void AAI_Elite::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UCombatFrameSubsystem* CombatFrame = UCombatFrameSubsystem::Get(this))
+	{
+		CombatFrame->RemoveStageWork(this);
+		CombatFrame->UnregisterEnemy(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AAI_Elite::Tick(float DeltaTime)
@@ -165,12 +191,83 @@ void AAI_Elite::Tick(float DeltaTime)
 	float DistanceToPlayer = FVector::Dist(GetActorLocation(), PlayerPawn->GetActorLocation());
 	RingMesh->SetVisibility((DistanceToPlayer >= 1000.f));
 
-	if (IsAttacking || bIsKicking || bIsExecutingSummon || isThrowingAxe || bUsingChain)
+	// Perception and combat decisions run as stages of the combat frame (see UCombatFrameSubsystem)
+}
+
+void AAI_Elite::GatherPerceptionInputs()
+{
+	// Component transforms are only safe to read on the game thread, so cache them for the perception stage
+	bPerceptionActive = !bIsInDamageState && CameraRef != nullptr;
+	if (!bPerceptionActive)
 	{
-		GetController<AAIController>()->StopMovement();
+		return;
 	}
 
-	
+	PerceptionEyeLocation = CameraRef->GetComponentLocation();
+	PerceptionEyeRotation = CameraRef->GetComponentRotation();
+	PerceptionFOV = CameraRef->FieldOfView;
+	PerceptionLocation = GetActorLocation();
+}
+
+void AAI_Elite::UpdatePerception(const FCombatSnapshot& Snapshot)
+{
+	// Once the player has been found we never lose them, so the ray fan is only needed until then
+	if (!bPerceptionActive || bHasFoundPlayer || !Snapshot.PlayerRaw)
+	{
+		return;
+	}
+
+	constexpr float DetectionRadius = 2000.0f; // AI notices player within this range
+	if (FVector::Dist(PerceptionLocation, Snapshot.PlayerLocation) <= DetectionRadius)
+	{
+		bHasFoundPlayer = true;
+		return;
+	}
+
+	// Define the FOV parameters
+	float FOVAngle = PerceptionFOV; // In degrees
+	float HalfFOVAngle = FOVAngle * 0.7f; // Half of the FOV angle
+
+	// Calculate the number of rays to cast within the FOV
+	int NumRays = 500; // Adjust this value to control the density of rays
+
+	// Calculate the angle between each ray
+	float AngleBetweenRays = FOVAngle / (NumRays - 1);
+
+	// Perform ray tracing for each ray within the FOV
+	FCollisionQueryParams QueryParams;
+	for (int i = 0; i < NumRays; i++)
+	{
+		// Calculate the angle for the current ray
+		float CurrentAngle = -HalfFOVAngle + (i * AngleBetweenRays);
+
+		// Convert the angle to a rotation
+		FRotator RayRotation(PerceptionEyeRotation.Pitch, PerceptionEyeRotation.Yaw + CurrentAngle, PerceptionEyeRotation.Roll);
+
+		// Calculate the end location of the ray
+		FVector RayEndLocation = PerceptionEyeLocation + (RayRotation.Vector() * 5000.0f); // Adjust this value to control the ray length
+
+		// Perform the line trace
+		FHitResult HitResult;
+		if (GetWorld()->LineTraceSingleByChannel(HitResult, PerceptionEyeLocation, RayEndLocation, ECC_Pawn, QueryParams))
+		{
+			// If the line trace hits the player's pawn, the AI can see the player
+			if (HitResult.GetActor() == Snapshot.PlayerRaw)
+			{
+				bHasFoundPlayer = true;
+				return;
+			}
+		}
+	}
+}
+
+void AAI_Elite::UpdateCombatDecision(const FCombatSnapshot& Snapshot)
+{
+	// Don't process AI behavior if in damage state (stunned)
+	if (bIsInDamageState || !Snapshot.PlayerRaw)
+	{
+		return;
+	}
 
 	AAIController* AIController = Cast<AAIController>(GetController());
         if (!AIController)
@@ -179,11 +276,10 @@ void AAI_Elite::Tick(float DeltaTime)
             return;
         }
 
-        // Get the distance to the player
-	//DistanceToPlayer = FVector::Dist(GetActorLocation(), PlayerPawn->GetActorLocation());
+	APawn* TargetPawn = Snapshot.Player.Get();
+	const float DistanceToPlayer = FVector::Dist(GetActorLocation(), Snapshot.PlayerLocation);
 
-        // Define the detection and stopping distances
-        constexpr float DetectionRadius = 2000.0f; // AI notices player within this range
+        // Define the stopping distance
         constexpr float StopRadius = 150.0f; // AI stops moving if within this range
 		constexpr float RunStartDistance = 150.0f; // AI starts running if closer than this
 		float RunStopDistance = 400.0f;
@@ -214,52 +310,6 @@ void AAI_Elite::Tick(float DeltaTime)
 			MovementComponent->MaxWalkSpeed = TargetSpeed;
 		}
 
-    	// Get camera location and rotation
-    	FVector CameraLocation = CameraRef->GetComponentLocation();
-    	FRotator CameraRotation = CameraRef->GetComponentRotation();
-
-    	// Define the FOV parameters
-    	float FOVAngle = CameraRef->FieldOfView; // In degrees
-    	float HalfFOVAngle = FOVAngle * 0.7f; // Half of the FOV angle
-
-    	// Calculate the number of rays to cast within the FOV
-    	int NumRays = 500; // Adjust this value to control the density of rays
-
-    	// Calculate the angle between each ray
-    	float AngleBetweenRays = FOVAngle / (NumRays - 1);
-
-    	// Perform ray tracing for each ray within the FOV
-    	for (int i = 0; i < NumRays; i++)
-    	{
-    		// Calculate the angle for the current ray
-    		float CurrentAngle = -HalfFOVAngle + (i * AngleBetweenRays);
-
-    		// Convert the angle to a rotation
-    		FRotator RayRotation = CameraRotation;
-    		RayRotation = FRotator(CameraRotation.Pitch, CameraRotation.Yaw + CurrentAngle, CameraRotation.Roll);
-
-
-    		// Calculate the end location of the ray
-    		FVector RayEndLocation = CameraLocation + (RayRotation.Vector() * 5000.0f); // Adjust this value to control the ray length
-
-    		// Perform the line trace
-    		FCollisionQueryParams QueryParams;
-    		FHitResult HitResult;
-    		if (GetWorld()->LineTraceSingleByChannel(HitResult, CameraLocation, RayEndLocation, ECC_Pawn, QueryParams))
-    		{
-    			// If the line trace hits the player's pawn, the AI can see the player
-    			if (HitResult.GetActor() == PlayerPawn)
-    			{
-    				bHasFoundPlayer = true;
-    			}
-    		}
-    	}
-	
-        if (DistanceToPlayer <= DetectionRadius)
-        {
-        	bHasFoundPlayer = true;
-        }
-
 	if (DistanceToPlayer > 350.0f && bHasFoundPlayer && !bIsDead && !bIsBlocking)
 	{
 		int32 RandomNumber = FMath::RandRange(0, 100);
@@ -278,26 +328,23 @@ void AAI_Elite::Tick(float DeltaTime)
 		}
 		
 	}
-	else
-	{
-		GetController<AAIController>()->MoveToActor(PlayerPawn, 5.0f, true, true, false, nullptr, true);
-	}
 
 	if (DistanceToPlayer < 600.0f)
 	{
 		isThrowingAxe = false;
 	}
 
+	// One move or stop per decision; the branches above used to stop and re-request the same move within a tick
 	if (bHasFoundPlayer && DistanceToPlayer > StopRadius) {
-		GetController<AAIController>()->MoveToActor(PlayerPawn, 5.0f, true, true, false, nullptr, true);
+		UCombatNavigationSubsystem::MoveToActor(AIController, TargetPawn);
 	}
 	else
 	{
-		GetController<AAIController>()->StopMovement();
-
 		// Check if within attack range
 		if (DistanceToPlayer <= AttackRange)
 		{
+			UCombatNavigationSubsystem::StopMovement(AIController);
+
 			// Only start a new attack if not already attacking and cooldown has expired
 			if (bCanAttack && !bIsExecutingAttack)
 			{
@@ -307,7 +354,7 @@ void AAI_Elite::Tick(float DeltaTime)
 					if (DistanceToPlayer <= AttackRange - 20.f && bCanKick)
 					{
 						EndShieldBlock();
-						KickPlayer(PlayerPawn, AIController);
+						KickPlayer(TargetPawn, AIController);
 						bIsKicking = true;
 					}
 					else
@@ -315,7 +362,7 @@ void AAI_Elite::Tick(float DeltaTime)
 						if (!bIsKicking)
 						{
 							EndShieldBlock();
-							AttackPlayer(PlayerPawn, AIController);
+							AttackPlayer(TargetPawn, AIController);
 							IsAttacking = true;
 						}
 					}
@@ -331,27 +378,23 @@ void AAI_Elite::Tick(float DeltaTime)
 			}
 			if (!bIsInDamageState)
 			{
-				AIController->MoveToActor(PlayerPawn, 5.0f, true, true, true, nullptr, true);
+				UCombatNavigationSubsystem::MoveToActor(AIController, TargetPawn, 5.0f, true);
 			}
 		}
 	}
 }
 
-
 void AAI_Elite::AttackPlayer(APawn* Pawn, AController* AIController)
 {
-	UGameplayStatics::PlaySoundAtLocation(
+	UCombatAudioSubsystem::PlayCue(
 			this,           // World context object
 			AxeSwingSound,// Sound to play
 			GetActorLocation(), // Location to play sound
-			0.4f,           // Volume multiplier
-			1.0f,           // Pitch multiplier
-			0.0f,           // Start time
-			nullptr,        // Attenuation settings
-			nullptr         // Concurrency settings
+			ECombatAudioCategory::Weapon,
+			0.4f            // Volume multiplier
 		);
 	CurrentAttackNumber = FMath::RandRange(0, 1);
-	GetController<AAIController>()->StopMovement();
+	UCombatNavigationSubsystem::StopMovement(GetController<AAIController>());
 	if (!bCanAttack || bIsDead || bIsInDamageState || bIsExecutingAttack)
 	{
 		return;
@@ -454,7 +497,7 @@ void AAI_Elite::ResetKickCooldown()
 
 void AAI_Elite::KickPlayer(APawn* Pawn, AController* AIController)
 {
-	GetController<AAIController>()->StopMovement();
+	UCombatNavigationSubsystem::StopMovement(GetController<AAIController>());
 	if (!bCanAttack || bIsDead || bIsInDamageState || bIsExecutingAttack)
 	{
 		return;
@@ -593,26 +636,21 @@ float AAI_Elite::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent,
 	}
 
 	isThrowingAxe = false;
+	AxeThrowMove.Cancel();
 	AAIController* AIController = Cast<AAIController>(GetController());
-	if (AIController)
-	{
-		AIController->StopMovement();
-	}
+	UCombatNavigationSubsystem::StopMovement(AIController);
 	bIsInDamageState = true;
 
 	if (bIsBlocking)
 	{
 		// Reduce damage when blocking, for example by 50%
 		DamageAmount *= 0.1f;
-		UGameplayStatics::PlaySoundAtLocation(
+		UCombatAudioSubsystem::PlayCue(
 			this,           // World context object
 			ShieldHitSound,// Sound to play
 			GetActorLocation(), // Location to play sound
-			0.4f,           // Volume multiplier
-			1.0f,           // Pitch multiplier
-			0.0f,           // Start time
-			nullptr,        // Attenuation settings
-			nullptr         // Concurrency settings
+			ECombatAudioCategory::Impact,
+			0.4f            // Volume multiplier
 		);
 
 		AMyProjectTest2Character* PlayerCharacter = Cast<AMyProjectTest2Character>(CurrentTarget);
@@ -646,15 +684,12 @@ float AAI_Elite::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent,
 	}
 	else
 	{
-		UGameplayStatics::PlaySoundAtLocation(
+		UCombatAudioSubsystem::PlayCue(
 		this,           // World context object
 		TakeDamageSound,// Sound to play
 		GetActorLocation(), // Location to play sound
-		0.4f,           // Volume multiplier
-		1.0f,           // Pitch multiplier
-		0.0f,           // Start time
-		nullptr,        // Attenuation settings
-		nullptr         // Concurrency settings
+		ECombatAudioCategory::Damage,
+		0.4f            // Volume multiplier
 	);
 	}
 	
@@ -681,11 +716,12 @@ float AAI_Elite::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent,
 		}
         
 		// Spawn the effect at the hit location
-		UNiagaraFunctionLibrary::SpawnSystemAtLocation(
-			GetWorld(),    // Get world context
+		UCombatFXSubsystem::SpawnAtLocation(
+			this,          // World context
 			HitEffect,     // Niagara system to spawn
 			HitLocation,   // Location of the hit
-			HitRotation    // Rotation to align with surface
+			HitRotation,   // Rotation to align with surface
+			ECombatFXPriority::Impact
 		);
 	}
     
@@ -831,15 +867,12 @@ void AAI_Elite::EnableRagdoll()
 		PlayerCharacter->AddHealth(15.0f);
 	}
     
-	UGameplayStatics::PlaySoundAtLocation(
+	UCombatAudioSubsystem::PlayCue(
 		this,
 		DeathSound,
 		GetActorLocation(),
-		0.4f,
-		1.0f,
-		0.0f,
-		nullptr,
-		nullptr
+		ECombatAudioCategory::Death,
+		0.4f
 	);
 
 	// Disable capsule collision
@@ -902,22 +935,19 @@ void AAI_Elite::SummonGrunts()
 			return;
 		}
 
-		UGameplayStatics::PlaySoundAtLocation(
+		UCombatAudioSubsystem::PlayCue(
 			this,           // World context object
 			SummonSound,// Sound to play
 			GetActorLocation(), // Location to play sound
-			0.4f,           // Volume multiplier
-			1.0f,           // Pitch multiplier
-			0.0f,           // Start time
-			nullptr,        // Attenuation settings
-			nullptr         // Concurrency settings
+			ECombatAudioCategory::Ability,
+			0.4f            // Volume multiplier
 		);
 		
 		bCanSummonGrunts = false;
 		bIsExecutingSummon = true;
 
 		// Stop AI movement before summoning grunts
-		GetController<AAIController>()->StopMovement();
+		UCombatNavigationSubsystem::StopMovement(GetController<AAIController>());
 
 		// Schedule the actual summoning
 		GetWorldTimerManager().SetTimer(
@@ -1014,36 +1044,26 @@ void AAI_Elite::PerformAxeThrow()
 		false
 	);
 
-	GetWorldTimerManager().SetTimer(
-		AxeThrowCooldownExecutionHandle,
-		[this]()
+	// Release the axe one second into the wind-up and hold the throw pose for another second
+	AxeThrowMove.Reset()
+		.Wait(1.f)
+		.Then([this]()
 		{
 			ThrowAxe();
-			UGameplayStatics::PlaySoundAtLocation(
+			UCombatAudioSubsystem::PlayCue(
 				this,           // World context object
 				AxeThrowSound,// Sound to play
 				GetActorLocation(), // Location to play sound
-				0.4f,           // Volume multiplier
-				1.0f,           // Pitch multiplier
-				0.0f,           // Start time
-				nullptr,        // Attenuation settings
-				nullptr         // Concurrency settings
+				ECombatAudioCategory::Weapon,
+				0.4f            // Volume multiplier
 			);
-		},
-		1.f,
-		false
-	);
-
-	GetWorldTimerManager().SetTimer(
-		AxeThrowTimerHandle,
-		[this]()
+		})
+		.Wait(1.f)
+		.Finally([this](bool bWasCancelled)
 		{
 			isThrowingAxe = false;
-		},
-		2.f,
-		false
-	);
-	
+		});
+	AxeThrowMove.Start(this);
 }
 
 void AAI_Elite::ThrowAxe()
@@ -1057,31 +1077,24 @@ void AAI_Elite::ThrowAxe()
 	{
 		// Get the skeletal mesh component
 		USkeletalMeshComponent* MeshComponent = GetMesh();
-		if (MeshComponent)
-		{
-			// Get the socket transform
-			FTransform SocketTransform = MeshComponent->GetSocketTransform("RightHandSocket");
 
-			// Use the socket location and rotation for spawning
-			FVector SpawnLocation = SocketTransform.GetLocation();
-			FRotator SpawnRotation = SocketTransform.Rotator();
+		// Spawn from the right hand socket, or fall back to the actor if the mesh component is not found
+		FVector SpawnLocation = MeshComponent ? MeshComponent->GetSocketTransform("RightHandSocket").GetLocation() : GetActorLocation();
+		FRotator SpawnRotation = MeshComponent ? FRotator::ZeroRotator : GetActorRotation();
 
-			AElite_ThrowableAxe* Axe = GetWorld()->SpawnActor<AElite_ThrowableAxe>(EliteThrowableAxeClass, SpawnLocation, FRotator(0,0,0));
-			if (Axe)
-			{
-				Axe->ThrowAxe(PlayerPawn->GetActorLocation(), this, PlayerPawn);
-			}
-		}
-		else
+		// Each axe's path is closed-form, so a volley only costs one cheap actor per axe.
+		// Targets fan out around the player, centered on the player's current location
+		const FVector ToPlayer = PlayerPawn->GetActorLocation() - GetActorLocation();
+		const int32 VolleyCount = FMath::Max(AxeVolleyCount, 1);
+		for (int32 AxeIndex = 0; AxeIndex < VolleyCount; ++AxeIndex)
 		{
-			// Fallback to using actor location and rotation if mesh component is not found
-			FVector SpawnLocation = GetActorLocation();
-			FRotator SpawnRotation = GetActorRotation();
+			const float YawOffset = (AxeIndex - (VolleyCount - 1) * 0.5f) * AxeVolleySpread;
+			const FVector TargetLocation = GetActorLocation() + ToPlayer.RotateAngleAxis(YawOffset, FVector::UpVector);
 
 			AElite_ThrowableAxe* Axe = GetWorld()->SpawnActor<AElite_ThrowableAxe>(EliteThrowableAxeClass, SpawnLocation, SpawnRotation);
 			if (Axe)
 			{
-				Axe->ThrowAxe(PlayerPawn->GetActorLocation(), this, PlayerPawn);
+				Axe->ThrowAxe(TargetLocation, this, PlayerPawn);
 			}
 		}
 	}
@@ -1117,9 +1130,10 @@ void AAI_Elite::ThrowChain()
 
 	
 
-	GetWorldTimerManager().SetTimer(
-		ChainExecuteTimerHandle,
-		[this]()
+	// Launch the chain half a second in, then hold until it has retracted
+	ChainMove.Reset()
+		.Wait(.5f)
+		.Then([this]()
 		{
 			if (ChainProjectileClass && PlayerPawn)
 			{
@@ -1140,6 +1154,7 @@ void AAI_Elite::ThrowChain()
 					Chain->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
 			
 					Chain->LaunchChain(PlayerPawn, this);
+					ActiveChain = Chain;
 					UE_LOG(LogTemp, Warning, TEXT("Chain spawned successfully"))
 				}
 				else
@@ -1147,20 +1162,14 @@ void AAI_Elite::ThrowChain()
 					UE_LOG(LogTemp, Warning, TEXT("Failed to spawn Chain"));
 				}
 			}
-		},
-		.5f,
-		false
-	);
-
-	GetWorldTimerManager().SetTimer(
-		ChainTimerHandle,
-		[this]()
+		})
+		.WaitUntil([this]() { return !ActiveChain.IsValid(); }, 2.f)
+		.Finally([this](bool bWasCancelled)
 		{
 			bUsingChain = false;
-		},
-		2.5f,
-		false
-	);
+			ActiveChain = nullptr;
+		});
+	ChainMove.Start(this);
 
 	GetWorldTimerManager().SetTimer(
 		ChainCooldownTimerHandle,
@@ -1248,13 +1257,14 @@ void AAI_Elite::PerformStomp()
 	// Play stomp sound
 	if (StompSound)
 	{
-		UGameplayStatics::PlaySoundAtLocation(this, StompSound, GetActorLocation());
+		UCombatAudioSubsystem::PlayCue(this, StompSound, GetActorLocation(), ECombatAudioCategory::Ability);
 	}
 
 	// Spawn stomp effect
 	if (StompEffect)
 	{
-		UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(), StompEffect, GetActorLocation());
+		// Stomp telegraphs a hit, so it is never culled
+		UCombatFXSubsystem::SpawnAtLocation(this, StompEffect, GetActorLocation(), FRotator::ZeroRotator, ECombatFXPriority::Critical);
 	}
 
 	// Check if PlayerPawn is valid and within the stomp radius
@@ -0,0 +1,330 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CombatAudioSubsystem.h"
+#include "Components/AudioComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Sound/SoundBase.h"
+#include "Sound/SoundConcurrency.h"
+
+DECLARE_STATS_GROUP(TEXT("Combat Audio"), STATGROUP_CombatAudio, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Played"), STAT_CombatAudioPlayed, STATGROUP_CombatAudio);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Culled"), STAT_CombatAudioCulled, STATGROUP_CombatAudio);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Merged"), STAT_CombatAudioMerged, STATGROUP_CombatAudio);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Stolen"), STAT_CombatAudioStolen, STATGROUP_CombatAudio);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dropped"), STAT_CombatAudioDropped, STATGROUP_CombatAudio);
+
+static TAutoConsoleVariable<int32> CVarCombatAudioMaxVoices(
+	TEXT("Combat.Audio.MaxVoices"),
+	32,
+	TEXT("Most combat one-shots playing at once. Only read when a new voice would be created."));
+
+static TAutoConsoleVariable<int32> CVarCombatAudioMaxStartsPerFrame(
+	TEXT("Combat.Audio.MaxStartsPerFrame"),
+	12,
+	TEXT("Most combat cues started in one frame. Cues past it merge into a nearby voice playing the same sound or are dropped. Player and Death cues always start."));
+
+static TAutoConsoleVariable<float> CVarCombatAudioMergeRadius(
+	TEXT("Combat.Audio.MergeRadius"),
+	300.f,
+	TEXT("A sound that started this close by within the merge window is made louder instead of started again. 0 disables."));
+
+static TAutoConsoleVariable<float> CVarCombatAudioMergeWindow(
+	TEXT("Combat.Audio.MergeWindow"),
+	0.08f,
+	TEXT("Seconds a started cue keeps absorbing nearby cues for the same sound."));
+
+namespace CombatAudio
+{
+	struct FCategoryRules
+	{
+		int32 MaxConcurrent;
+		float Priority;
+		EMaxConcurrentResolutionRule::Type Resolution;
+	};
+
+	// Indexed by ECombatAudioCategory
+	static const FCategoryRules CategoryRules[] =
+	{
+		{ 6, 0.2f, EMaxConcurrentResolutionRule::StopQuietest }, // Footstep
+		{ 8, 0.5f, EMaxConcurrentResolutionRule::StopOldest },   // Impact
+		{ 6, 0.6f, EMaxConcurrentResolutionRule::StopOldest },   // Weapon
+		{ 6, 0.7f, EMaxConcurrentResolutionRule::StopOldest },   // Damage
+		{ 4, 0.8f, EMaxConcurrentResolutionRule::StopOldest },   // Death
+		{ 4, 0.9f, EMaxConcurrentResolutionRule::StopOldest },   // Ability
+		{ 4, 1.0f, EMaxConcurrentResolutionRule::StopOldest },   // Player
+	};
+	static_assert(UE_ARRAY_COUNT(CategoryRules) == static_cast<int32>(ECombatAudioCategory::Count), "One rule per audio category");
+
+	static const FCategoryRules& GetRules(ECombatAudioCategory Category)
+	{
+		return CategoryRules[static_cast<int32>(Category)];
+	}
+
+	// Player feedback and deaths are never given up to a burst of lower priority cues
+	static bool IsFrameBudgeted(ECombatAudioCategory Category)
+	{
+		return Category != ECombatAudioCategory::Player && Category != ECombatAudioCategory::Death;
+	}
+
+	// Over budget, a cue may merge into a voice of its sound this many merge radii away rather than be dropped
+	static constexpr float OverBudgetMergeScale = 4.f;
+}
+
+const FName UCombatAudioSubsystem::IntensityParameter(TEXT("Intensity"));
+
+UCombatAudioSubsystem* UCombatAudioSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UCombatAudioSubsystem>() : nullptr;
+}
+
+UAudioComponent* UCombatAudioSubsystem::PlayCue(const UObject* WorldContextObject, USoundBase* Sound, const FVector& Location,
+	ECombatAudioCategory Category, float VolumeMultiplier, float PitchMultiplier)
+{
+	if (UCombatAudioSubsystem* CombatAudio = Get(WorldContextObject))
+	{
+		return CombatAudio->Play(Sound, Location, Category, VolumeMultiplier, PitchMultiplier);
+	}
+
+	if (Sound)
+	{
+		UGameplayStatics::PlaySoundAtLocation(WorldContextObject, Sound, Location, VolumeMultiplier, PitchMultiplier);
+	}
+	return nullptr;
+}
+
+bool UCombatAudioSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatAudioSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// One concurrency group per category, so a crowd's footsteps can't crowd out its deaths
+	CategoryConcurrency.SetNum(CategoryCount);
+	for (int32 Index = 0; Index < CategoryCount; ++Index)
+	{
+		const CombatAudio::FCategoryRules& Rules = CombatAudio::CategoryRules[Index];
+		USoundConcurrency* Concurrency = NewObject<USoundConcurrency>(this);
+		Concurrency->Concurrency.MaxCount = Rules.MaxConcurrent;
+		Concurrency->Concurrency.ResolutionRule = Rules.Resolution;
+		Concurrency->Concurrency.bLimitToOwner = false;
+		CategoryConcurrency[Index] = Concurrency;
+	}
+}
+
+void UCombatAudioSubsystem::Deinitialize()
+{
+	for (const FVoice& Voice : Voices)
+	{
+		if (UAudioComponent* Component = Voice.Component.Get())
+		{
+			Component->Stop();
+			Component->DestroyComponent();
+		}
+	}
+	Voices.Empty();
+	RecentCues.Empty();
+	CategoryConcurrency.Empty();
+
+	Super::Deinitialize();
+}
+
+UAudioComponent* UCombatAudioSubsystem::Play(USoundBase* Sound, const FVector& Location, ECombatAudioCategory Category, float VolumeMultiplier, float PitchMultiplier)
+{
+	if (!Sound)
+	{
+		return nullptr;
+	}
+
+	BeginFrameIfNeeded();
+
+	if (Category != ECombatAudioCategory::Player && bHasListener
+		&& FVector::DistSquared(Location, ListenerLocation) > FMath::Square(Sound->GetMaxDistance()))
+	{
+		++Stats.Culled;
+		INC_DWORD_STAT(STAT_CombatAudioCulled);
+		return nullptr;
+	}
+
+	// A dozen grunts hit by one swing should sound like one heavier hit
+	const TObjectKey<USoundBase> SoundKey(Sound);
+	const float MergeRadius = CVarCombatAudioMergeRadius.GetValueOnGameThread();
+	if (FRecentCue* Target = MergeRadius > 0.f ? FindMergeTarget(SoundKey, Location, MergeRadius) : nullptr)
+	{
+		return Merge(*Target);
+	}
+
+	if (CombatAudio::IsFrameBudgeted(Category) && StartsThisFrame >= CVarCombatAudioMaxStartsPerFrame.GetValueOnGameThread())
+	{
+		if (FRecentCue* Target = MergeRadius > 0.f ? FindMergeTarget(SoundKey, Location, MergeRadius * CombatAudio::OverBudgetMergeScale) : nullptr)
+		{
+			return Merge(*Target);
+		}
+
+		++Stats.Dropped;
+		INC_DWORD_STAT(STAT_CombatAudioDropped);
+		return nullptr;
+	}
+
+	UAudioComponent* Component = AcquireVoice(Category);
+	if (!Component)
+	{
+		++Stats.Dropped;
+		INC_DWORD_STAT(STAT_CombatAudioDropped);
+		return nullptr;
+	}
+
+	Component->SetWorldLocation(Location);
+	Component->SetSound(Sound);
+	Component->SetVolumeMultiplier(VolumeMultiplier);
+	Component->SetPitchMultiplier(PitchMultiplier);
+	Component->bOverridePriority = true;
+	Component->Priority = CombatAudio::GetRules(Category).Priority;
+	Component->ConcurrencySet.Reset();
+	Component->ConcurrencySet.Add(CategoryConcurrency[static_cast<int32>(Category)]);
+	Component->SetFloatParameter(IntensityParameter, 1.f);
+	Component->Play();
+
+	RecentCues.Add({ SoundKey, Location, GetWorld()->GetTimeSeconds(), Component, VolumeMultiplier });
+	++StartsThisFrame;
+	++Stats.Played;
+	INC_DWORD_STAT(STAT_CombatAudioPlayed);
+	return Component;
+}
+
+void UCombatAudioSubsystem::BeginFrameIfNeeded()
+{
+	if (CurrentFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	CurrentFrame = GFrameCounter;
+	StartsThisFrame = 0;
+
+	const double OldestTime = GetWorld()->GetTimeSeconds() - CVarCombatAudioMergeWindow.GetValueOnGameThread();
+	RecentCues.RemoveAllSwap([OldestTime](const FRecentCue& Cue)
+	{
+		return Cue.Time < OldestTime || !Cue.Component.IsValid();
+	});
+
+	// The listener only moves between frames, so read it once
+	const APlayerController* PlayerController = UGameplayStatics::GetPlayerController(this, 0);
+	bHasListener = PlayerController != nullptr;
+	if (bHasListener)
+	{
+		FVector FrontDir;
+		FVector RightDir;
+		PlayerController->GetAudioListenerPosition(ListenerLocation, FrontDir, RightDir);
+	}
+}
+
+UCombatAudioSubsystem::FRecentCue* UCombatAudioSubsystem::FindMergeTarget(const TObjectKey<USoundBase>& Sound, const FVector& Location, float MaxDistance)
+{
+	FRecentCue* Closest = nullptr;
+	float ClosestDistanceSquared = FMath::Square(MaxDistance);
+	for (FRecentCue& Cue : RecentCues)
+	{
+		const float DistanceSquared = FVector::DistSquared(Cue.Location, Location);
+		if (Cue.Sound == Sound && DistanceSquared <= ClosestDistanceSquared)
+		{
+			// The voice may have been stolen for another sound since
+			const UAudioComponent* Component = Cue.Component.Get();
+			if (Component && Component->IsPlaying() && Component->Sound == Cue.Sound.ResolveObjectPtr())
+			{
+				Closest = &Cue;
+				ClosestDistanceSquared = DistanceSquared;
+			}
+		}
+	}
+	return Closest;
+}
+
+UAudioComponent* UCombatAudioSubsystem::Merge(FRecentCue& Target)
+{
+	UAudioComponent* Component = Target.Component.Get();
+	++Target.Requests;
+
+	// Loudness grows with the log of the merged count so a big crowd reads as heavier, not deafening
+	Component->SetVolumeMultiplier(Target.BaseVolume * (1.f + 0.25f * FMath::Log2(static_cast<float>(Target.Requests))));
+	Component->SetFloatParameter(IntensityParameter, static_cast<float>(Target.Requests));
+
+	++Stats.Merged;
+	INC_DWORD_STAT(STAT_CombatAudioMerged);
+	return Component;
+}
+
+UAudioComponent* UCombatAudioSubsystem::AcquireVoice(ECombatAudioCategory Category)
+{
+	// Voices go away with the world settings actor on a level change
+	Voices.RemoveAll([](const FVoice& Voice) { return !Voice.Component.IsValid(); });
+
+	// Prefer an idle voice; otherwise remember the least important busy one
+	int32 LowestIndex = INDEX_NONE;
+	float LowestPriority = CombatAudio::GetRules(Category).Priority;
+	for (int32 Index = 0; Index < Voices.Num(); ++Index)
+	{
+		FVoice& Voice = Voices[Index];
+		UAudioComponent* Component = Voice.Component.Get();
+		if (!Component->IsPlaying())
+		{
+			Voice.Category = Category;
+			return Component;
+		}
+
+		const float VoicePriority = CombatAudio::GetRules(Voice.Category).Priority;
+		if (VoicePriority < LowestPriority)
+		{
+			LowestPriority = VoicePriority;
+			LowestIndex = Index;
+		}
+	}
+
+	if (Voices.Num() < CVarCombatAudioMaxVoices.GetValueOnGameThread())
+	{
+		if (UAudioComponent* Component = CreateVoice())
+		{
+			Voices.Add({ Component, Category });
+			return Component;
+		}
+	}
+
+	if (LowestIndex == INDEX_NONE)
+	{
+		return nullptr;
+	}
+
+	FVoice& Stolen = Voices[LowestIndex];
+	UAudioComponent* Component = Stolen.Component.Get();
+	Component->Stop();
+	Stolen.Category = Category;
+	++Stats.Stolen;
+	INC_DWORD_STAT(STAT_CombatAudioStolen);
+	return Component;
+}
+
+UAudioComponent* UCombatAudioSubsystem::CreateVoice()
+{
+	UWorld* World = GetWorld();
+	AWorldSettings* WorldSettings = World ? World->GetWorldSettings() : nullptr;
+	if (!WorldSettings)
+	{
+		return nullptr;
+	}
+
+	// Owned by the world settings so the voices live as long as the level and are never auto destroyed
+	UAudioComponent* Component = NewObject<UAudioComponent>(WorldSettings);
+	Component->bAutoActivate = false;
+	Component->bAutoDestroy = false;
+	Component->bAllowSpatialization = true;
+	Component->bIsUISound = false;
+	Component->RegisterComponentWithWorld(World);
+	return Component;
+}
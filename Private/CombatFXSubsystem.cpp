@@ -0,0 +1,252 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CombatFXSubsystem.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "NiagaraComponent.h"
+#include "NiagaraComponentPool.h"
+#include "NiagaraFunctionLibrary.h"
+#include "NiagaraSystem.h"
+#include "NiagaraWorldManager.h"
+
+DECLARE_STATS_GROUP(TEXT("Combat FX"), STATGROUP_CombatFX, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Spawned"), STAT_CombatFXSpawned, STATGROUP_CombatFX);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Culled"), STAT_CombatFXCulled, STATGROUP_CombatFX);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Coalesced"), STAT_CombatFXCoalesced, STATGROUP_CombatFX);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Over Budget"), STAT_CombatFXOverBudget, STATGROUP_CombatFX);
+
+static TAutoConsoleVariable<int32> CVarCombatFXMaxSpawnsPerFrame(
+	TEXT("Combat.FX.MaxSpawnsPerFrame"),
+	24,
+	TEXT("Most non-critical combat effects spawned in one frame. Cosmetic effects only get half of it."));
+
+static TAutoConsoleVariable<int32> CVarCombatFXMaxSpawnsPerEffect(
+	TEXT("Combat.FX.MaxSpawnsPerEffect"),
+	6,
+	TEXT("Most non-critical spawns of any one Niagara system in one frame."));
+
+static TAutoConsoleVariable<int32> CVarCombatFXHardCeiling(
+	TEXT("Combat.FX.HardCeiling"),
+	48,
+	TEXT("Most non-critical combat effects spawned in one frame, whatever the other budgets allow. Critical spawns count toward it but are never held back by it."));
+
+static TAutoConsoleVariable<float> CVarCombatFXCoalesceRadius(
+	TEXT("Combat.FX.CoalesceRadius"),
+	150.f,
+	TEXT("A request for a system spawned this close by within the coalesce window is merged into that spawn. 0 disables."));
+
+namespace CombatFX
+{
+	// Over budget, a request may merge into a spawn of its system this many coalesce radii away rather than be dropped
+	static constexpr float OverBudgetMergeScale = 4.f;
+}
+
+static TAutoConsoleVariable<float> CVarCombatFXCoalesceWindow(
+	TEXT("Combat.FX.CoalesceWindow"),
+	0.1f,
+	TEXT("Seconds a spawned effect keeps absorbing nearby requests for the same system."));
+
+static TAutoConsoleVariable<float> CVarCombatFXCullDistance(
+	TEXT("Combat.FX.CullDistance"),
+	8000.f,
+	TEXT("Non-critical effects further than this from the camera are not spawned."));
+
+static TAutoConsoleVariable<float> CVarCombatFXOffscreenGrace(
+	TEXT("Combat.FX.OffscreenGraceDistance"),
+	600.f,
+	TEXT("Effects closer than this to the camera are kept even when off screen, since their particles can drift into view."));
+
+const FName UCombatFXSubsystem::IntensityParameter(TEXT("Intensity"));
+
+UCombatFXSubsystem* UCombatFXSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UCombatFXSubsystem>() : nullptr;
+}
+
+UNiagaraComponent* UCombatFXSubsystem::SpawnAtLocation(const UObject* WorldContextObject, UNiagaraSystem* System, const FVector& Location,
+	const FRotator& Rotation, ECombatFXPriority Priority, const FVector& Scale)
+{
+	if (UCombatFXSubsystem* CombatFX = Get(WorldContextObject))
+	{
+		return CombatFX->Spawn(System, Location, Rotation, Priority, Scale);
+	}
+
+	return System ? UNiagaraFunctionLibrary::SpawnSystemAtLocation(WorldContextObject, System, Location, Rotation, Scale) : nullptr;
+}
+
+bool UCombatFXSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatFXSubsystem::Deinitialize()
+{
+	RecentSpawns.Empty();
+	SpawnsPerEffect.Empty();
+
+	Super::Deinitialize();
+}
+
+void UCombatFXSubsystem::Prewarm(UNiagaraSystem* System)
+{
+	UWorld* World = GetWorld();
+	FNiagaraWorldManager* WorldManager = World && System ? FNiagaraWorldManager::Get(World) : nullptr;
+	if (WorldManager && WorldManager->GetComponentPool())
+	{
+		WorldManager->GetComponentPool()->PrimePool(System, World);
+	}
+}
+
+UNiagaraComponent* UCombatFXSubsystem::Spawn(UNiagaraSystem* System, const FVector& Location, const FRotator& Rotation, ECombatFXPriority Priority, const FVector& Scale)
+{
+	if (!System)
+	{
+		return nullptr;
+	}
+
+	BeginFrameIfNeeded();
+
+	if (Priority != ECombatFXPriority::Critical && IsCulled(Location))
+	{
+		++Stats.Culled;
+		INC_DWORD_STAT(STAT_CombatFXCulled);
+		return nullptr;
+	}
+
+	// A dozen grunts hit by one swing get one bigger effect rather than a dozen overlapping ones
+	const TObjectKey<UNiagaraSystem> SystemKey(System);
+	const float CoalesceRadius = CVarCombatFXCoalesceRadius.GetValueOnGameThread();
+	if (FRecentSpawn* Target = CoalesceRadius > 0.f ? FindMergeTarget(SystemKey, Location, CoalesceRadius) : nullptr)
+	{
+		return Merge(*Target);
+	}
+
+	// Critical effects are the player's feedback and telegraphs, so no burst of other effects may hold them back
+	bool bOverBudget = false;
+	int32* EffectSpawns = nullptr;
+	if (Priority != ECombatFXPriority::Critical)
+	{
+		const int32 FrameBudget = FMath::Min(CVarCombatFXMaxSpawnsPerFrame.GetValueOnGameThread(), CVarCombatFXHardCeiling.GetValueOnGameThread());
+		const int32 Budget = Priority == ECombatFXPriority::Cosmetic ? FrameBudget / 2 : FrameBudget;
+		EffectSpawns = &SpawnsPerEffect.FindOrAdd(SystemKey);
+		bOverBudget = SpawnsThisFrame >= Budget || *EffectSpawns >= CVarCombatFXMaxSpawnsPerEffect.GetValueOnGameThread();
+	}
+
+	if (bOverBudget)
+	{
+		// Out of budget: better to make an effect of this kind close by bigger than to lose the feedback entirely
+		FRecentSpawn* Target = CoalesceRadius > 0.f ? FindMergeTarget(SystemKey, Location, CoalesceRadius * CombatFX::OverBudgetMergeScale) : nullptr;
+		if (Target)
+		{
+			return Merge(*Target);
+		}
+
+		++Stats.OverBudget;
+		INC_DWORD_STAT(STAT_CombatFXOverBudget);
+		return nullptr;
+	}
+
+	// Pooled components go back to the world's Niagara pool when the effect finishes instead of being destroyed
+	UNiagaraComponent* Component = UNiagaraFunctionLibrary::SpawnSystemAtLocation(
+		this, System, Location, Rotation, Scale, true, true, ENCPoolMethod::AutoRelease);
+	if (Component)
+	{
+		Component->SetVariableFloat(IntensityParameter, 1.f);
+		RecentSpawns.Add({ SystemKey, Location, GetWorld()->GetTimeSeconds(), Component });
+		++SpawnsThisFrame;
+		if (EffectSpawns)
+		{
+			++*EffectSpawns;
+		}
+		++Stats.Spawned;
+		INC_DWORD_STAT(STAT_CombatFXSpawned);
+	}
+	return Component;
+}
+
+UCombatFXSubsystem::FRecentSpawn* UCombatFXSubsystem::FindMergeTarget(const TObjectKey<UNiagaraSystem>& System, const FVector& Location, float MaxDistance)
+{
+	FRecentSpawn* Closest = nullptr;
+	float ClosestDistanceSquared = FMath::Square(MaxDistance);
+	for (FRecentSpawn& Recent : RecentSpawns)
+	{
+		const float DistanceSquared = FVector::DistSquared(Recent.Location, Location);
+		if (Recent.System == System && DistanceSquared <= ClosestDistanceSquared)
+		{
+			// Pooled components go back to the Niagara pool when they finish and may be running another system since
+			const UNiagaraComponent* Component = Recent.Component.Get();
+			if (Component && Component->IsActive() && Component->GetAsset() == Recent.System.ResolveObjectPtr())
+			{
+				Closest = &Recent;
+				ClosestDistanceSquared = DistanceSquared;
+			}
+		}
+	}
+	return Closest;
+}
+
+UNiagaraComponent* UCombatFXSubsystem::Merge(FRecentSpawn& Target)
+{
+	UNiagaraComponent* Component = Target.Component.Get();
+	++Target.Requests;
+	Component->SetVariableFloat(IntensityParameter, static_cast<float>(Target.Requests));
+
+	++Stats.Coalesced;
+	INC_DWORD_STAT(STAT_CombatFXCoalesced);
+	return Component;
+}
+
+void UCombatFXSubsystem::BeginFrameIfNeeded()
+{
+	if (CurrentFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	CurrentFrame = GFrameCounter;
+	SpawnsThisFrame = 0;
+	SpawnsPerEffect.Reset();
+
+	// Spawns stay merge targets for the coalesce window, which can span a few frames
+	const double OldestTime = GetWorld()->GetTimeSeconds() - CVarCombatFXCoalesceWindow.GetValueOnGameThread();
+	RecentSpawns.RemoveAllSwap([OldestTime](const FRecentSpawn& Recent)
+	{
+		return Recent.Time < OldestTime || !Recent.Component.IsValid();
+	});
+
+	// The camera only moves between frames, so read it once
+	const APlayerCameraManager* Camera = UGameplayStatics::GetPlayerCameraManager(this, 0);
+	bHasView = Camera != nullptr;
+	if (bHasView)
+	{
+		ViewLocation = Camera->GetCameraLocation();
+		ViewDirection = Camera->GetCameraRotation().Vector();
+		// Horizontal FOV is the wider one, so use it for the whole cone and err on the side of spawning
+		ViewCosHalfFOV = FMath::Cos(FMath::DegreesToRadians(FMath::Min(Camera->GetFOVAngle() * 0.5f + 10.f, 90.f)));
+	}
+}
+
+bool UCombatFXSubsystem::IsCulled(const FVector& Location) const
+{
+	if (!bHasView)
+	{
+		return false;
+	}
+
+	const FVector ToEffect = Location - ViewLocation;
+	const float DistanceSquared = ToEffect.SizeSquared();
+	if (DistanceSquared > FMath::Square(CVarCombatFXCullDistance.GetValueOnGameThread()))
+	{
+		return true;
+	}
+
+	if (DistanceSquared <= FMath::Square(CVarCombatFXOffscreenGrace.GetValueOnGameThread()))
+	{
+		return false;
+	}
+
+	return FVector::DotProduct(ToEffect * FMath::InvSqrt(DistanceSquared), ViewDirection) < ViewCosHalfFOV;
+}
@@ -0,0 +1,314 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CombatFlowFieldSubsystem.h"
+#include "CombatFrameSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "NavigationSystem.h"
+
+DECLARE_STATS_GROUP(TEXT("Combat Flow Field"), STATGROUP_CombatFlowField, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Update Field"), STAT_CombatFlowFieldUpdate, STATGROUP_CombatFlowField);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Builds"), STAT_CombatFlowFieldBuilds, STATGROUP_CombatFlowField);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cells Expanded"), STAT_CombatFlowFieldCellsExpanded, STATGROUP_CombatFlowField);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Navmesh Probes"), STAT_CombatFlowFieldProbes, STATGROUP_CombatFlowField);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Samples"), STAT_CombatFlowFieldSamples, STATGROUP_CombatFlowField);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Misses"), STAT_CombatFlowFieldMisses, STATGROUP_CombatFlowField);
+
+static TAutoConsoleVariable<float> CVarFlowFieldCellSize(
+	TEXT("Combat.FlowField.CellSize"),
+	100.f,
+	TEXT("Width of a flow field cell. Read when the grid is laid."));
+
+static TAutoConsoleVariable<int32> CVarFlowFieldGridSize(
+	TEXT("Combat.FlowField.GridSize"),
+	96,
+	TEXT("Flow field cells per side. Read when the grid is laid."));
+
+static TAutoConsoleVariable<int32> CVarFlowFieldCellsPerStep(
+	TEXT("Combat.FlowField.CellsPerStep"),
+	2048,
+	TEXT("Most cells a field rebuild expands or checks against the navmesh per sim step. Grunts sample the previous field until it's done."));
+
+static TAutoConsoleVariable<float> CVarFlowFieldDirectDistance(
+	TEXT("Combat.FlowField.DirectDistance"),
+	300.f,
+	TEXT("Grunts closer than this to the player leave the flow field and path to the player themselves."));
+
+namespace CombatFlowField
+{
+	// Neighbour directions, counter-clockwise from +X, so the opposite of D is (D + 4) % 8
+	static constexpr int32 DirectionCount = 8;
+	static const FIntPoint Offsets[DirectionCount] = { {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1} };
+	static constexpr uint8 NoDirection = 0xFF;
+	static constexpr uint8 AtPlayer = DirectionCount;
+
+	static constexpr float ProbeHeight = 400.f; // How far above or below the grid a cell's navmesh can be
+}
+
+bool UCombatFlowFieldSubsystem::FGrid::ToCell(const FVector& Location, int32& OutCell) const
+{
+	const int32 X = FMath::FloorToInt32((Location.X - Origin.X) / CellSize);
+	const int32 Y = FMath::FloorToInt32((Location.Y - Origin.Y) / CellSize);
+	if (!IsSet() || X < 0 || Y < 0 || X >= Size || Y >= Size)
+	{
+		return false;
+	}
+	OutCell = Y * Size + X;
+	return true;
+}
+
+FVector UCombatFlowFieldSubsystem::FGrid::GetCellCenter(int32 Cell) const
+{
+	return Origin + FVector((Cell % Size + 0.5f) * CellSize, (Cell / Size + 0.5f) * CellSize, 0.f);
+}
+
+UCombatFlowFieldSubsystem* UCombatFlowFieldSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UCombatFlowFieldSubsystem>() : nullptr;
+}
+
+bool UCombatFlowFieldSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatFlowFieldSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Registered before any grunt, so the field is up to date when their move requests sample it
+	if (UCombatFrameSubsystem* CombatFrame = UCombatFrameSubsystem::Get(this))
+	{
+		CombatFrame->AddStageWork(ECombatFrameStage::GatherSnapshot, this,
+			[this](const FCombatSnapshot& Snapshot, float) { UpdateField(Snapshot); });
+	}
+}
+
+void UCombatFlowFieldSubsystem::Deinitialize()
+{
+	if (UCombatFrameSubsystem* CombatFrame = UCombatFrameSubsystem::Get(this))
+	{
+		CombatFrame->RemoveStageWork(this);
+	}
+
+	Front = FField();
+	Back = FField();
+	CellStates.Empty();
+	CellHeights.Empty();
+	ShiftedCellStates.Empty();
+	ShiftedCellHeights.Empty();
+	Costs.Empty();
+	Open.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UCombatFlowFieldSubsystem::SampleDirection(const FVector& Location, FVector& OutDirection)
+{
+	++Stats.Samples;
+	INC_DWORD_STAT(STAT_CombatFlowFieldSamples);
+
+	int32 Cell = INDEX_NONE;
+	const bool bFar = bHasPlayer && FVector::DistSquared2D(Location, PlayerLocation) > FMath::Square(CVarFlowFieldDirectDistance.GetValueOnGameThread());
+	const uint8 Direction = bFar && Front.Grid.ToCell(Location, Cell) ? Front.Next[Cell] : CombatFlowField::NoDirection;
+	if (Direction >= CombatFlowField::DirectionCount)
+	{
+		++Stats.Misses;
+		INC_DWORD_STAT(STAT_CombatFlowFieldMisses);
+		return false;
+	}
+
+	// Head for the next cell's center from where the grunt actually is, which smooths the grid's 45 degree steps
+	const FIntPoint& Offset = CombatFlowField::Offsets[Direction];
+	const FVector Target = Front.Grid.GetCellCenter(Cell + Offset.Y * Front.Grid.Size + Offset.X);
+	OutDirection = (Target - Location).GetSafeNormal2D();
+	return !OutDirection.IsZero();
+}
+
+void UCombatFlowFieldSubsystem::UpdateField(const FCombatSnapshot& Snapshot)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CombatFlowFieldUpdate);
+
+	bHasPlayer = Snapshot.PlayerRaw != nullptr;
+	if (!bHasPlayer)
+	{
+		return;
+	}
+	PlayerLocation = Snapshot.PlayerLocation;
+	ProbesThisStep = 0;
+
+	if (NeedsNewGrid(PlayerLocation))
+	{
+		LayGrid(PlayerLocation);
+	}
+
+	// A build runs to the end before the next starts, so a player crossing cells faster than a build still gets fields
+	int32 PlayerCell = INDEX_NONE;
+	if (!bBuilding && Grid.ToCell(PlayerLocation, PlayerCell) && PlayerCell != SeedCell && IsWalkable(PlayerCell))
+	{
+		StartBuild(PlayerCell);
+	}
+
+	if (bBuilding && ContinueBuild(FMath::Max(CVarFlowFieldCellsPerStep.GetValueOnGameThread(), 1)))
+	{
+		bBuilding = false;
+		Swap(Front, Back);
+		++Stats.Builds;
+		INC_DWORD_STAT(STAT_CombatFlowFieldBuilds);
+	}
+}
+
+bool UCombatFlowFieldSubsystem::NeedsNewGrid(const FVector& Location) const
+{
+	// Keep the player in the middle half of the grid so grunts around them stay covered
+	int32 Cell;
+	if (!Grid.ToCell(Location, Cell))
+	{
+		return true;
+	}
+	const int32 Margin = Grid.Size / 4;
+	const int32 X = Cell % Grid.Size;
+	const int32 Y = Cell / Grid.Size;
+	return X < Margin || Y < Margin || X >= Grid.Size - Margin || Y >= Grid.Size - Margin;
+}
+
+void UCombatFlowFieldSubsystem::LayGrid(const FVector& Center)
+{
+	const FGrid OldGrid = Grid;
+	Grid.CellSize = FMath::Max(CVarFlowFieldCellSize.GetValueOnGameThread(), 10.f);
+	Grid.Size = FMath::Max(CVarFlowFieldGridSize.GetValueOnGameThread(), 8);
+
+	// Snap to whole cells so cells cover the same ground wherever the grid is laid
+	const float HalfExtent = Grid.Size * Grid.CellSize * 0.5f;
+	Grid.Origin = FVector(
+		FMath::GridSnap(Center.X - HalfExtent, Grid.CellSize),
+		FMath::GridSnap(Center.Y - HalfExtent, Grid.CellSize),
+		Center.Z);
+
+	// The origin is snapped, so a grid of the same shape only moved by whole cells and keeps what it learned
+	const bool bShifted = OldGrid.IsSet() && OldGrid.Size == Grid.Size && OldGrid.CellSize == Grid.CellSize
+		&& FMath::Abs(Grid.Origin.Z - OldGrid.Origin.Z) <= CombatFlowField::ProbeHeight * 0.5f;
+	if (bShifted)
+	{
+		Swap(CellStates, ShiftedCellStates);
+		Swap(CellHeights, ShiftedCellHeights);
+	}
+
+	CellStates.Init(ECellState::Unknown, Grid.Num());
+	CellHeights.SetNumUninitialized(Grid.Num());
+
+	if (bShifted)
+	{
+		const int32 ShiftX = FMath::RoundToInt32((Grid.Origin.X - OldGrid.Origin.X) / Grid.CellSize);
+		const int32 ShiftY = FMath::RoundToInt32((Grid.Origin.Y - OldGrid.Origin.Y) / Grid.CellSize);
+		for (int32 Y = FMath::Max(0, -ShiftY); Y < FMath::Min(Grid.Size, Grid.Size - ShiftY); ++Y)
+		{
+			for (int32 X = FMath::Max(0, -ShiftX); X < FMath::Min(Grid.Size, Grid.Size - ShiftX); ++X)
+			{
+				const int32 Cell = Y * Grid.Size + X;
+				const int32 OldCell = (Y + ShiftY) * Grid.Size + X + ShiftX;
+				CellStates[Cell] = ShiftedCellStates[OldCell];
+				CellHeights[Cell] = ShiftedCellHeights[OldCell];
+			}
+		}
+	}
+
+	SeedCell = INDEX_NONE;
+	bBuilding = false;
+}
+
+void UCombatFlowFieldSubsystem::StartBuild(int32 Cell)
+{
+	SeedCell = Cell;
+	bBuilding = true;
+
+	Back.Grid = Grid;
+	Back.Next.Init(CombatFlowField::NoDirection, Grid.Num());
+	Back.Next[Cell] = CombatFlowField::AtPlayer;
+	Costs.Init(MAX_flt, Grid.Num());
+	Costs[Cell] = 0.f;
+
+	Open.Reset();
+	Open.HeapPush({ 0.f, Cell });
+}
+
+bool UCombatFlowFieldSubsystem::ContinueBuild(int32 Budget)
+{
+	int32 Expanded = 0;
+	// Navmesh probes cost far more than an expansion, so they come out of the same budget
+	while (Open.Num() > 0 && Expanded + ProbesThisStep < Budget)
+	{
+		FOpenCell Current;
+		Open.HeapPop(Current);
+		if (Current.Cost > Costs[Current.Cell])
+		{
+			continue; // Reached more cheaply since it was queued
+		}
+		++Expanded;
+
+		const int32 X = Current.Cell % Grid.Size;
+		const int32 Y = Current.Cell / Grid.Size;
+		for (int32 Direction = 0; Direction < CombatFlowField::DirectionCount; ++Direction)
+		{
+			const FIntPoint& Offset = CombatFlowField::Offsets[Direction];
+			if (X + Offset.X < 0 || Y + Offset.Y < 0 || X + Offset.X >= Grid.Size || Y + Offset.Y >= Grid.Size)
+			{
+				continue;
+			}
+
+			const int32 Neighbour = Current.Cell + Offset.Y * Grid.Size + Offset.X;
+			const float Cost = Current.Cost + ((Direction & 1) ? UE_SQRT_2 : 1.f);
+			if (Cost >= Costs[Neighbour] || !CanStep(Current.Cell, Neighbour, Direction))
+			{
+				continue;
+			}
+
+			Costs[Neighbour] = Cost;
+			Back.Next[Neighbour] = static_cast<uint8>((Direction + CombatFlowField::DirectionCount / 2) % CombatFlowField::DirectionCount);
+			Open.HeapPush({ Cost, Neighbour });
+		}
+	}
+
+	Stats.CellsExpanded += Expanded;
+	INC_DWORD_STAT_BY(STAT_CombatFlowFieldCellsExpanded, Expanded);
+	return Open.Num() == 0;
+}
+
+bool UCombatFlowFieldSubsystem::IsWalkable(int32 Cell)
+{
+	if (CellStates[Cell] == ECellState::Unknown)
+	{
+		CellStates[Cell] = ECellState::Blocked;
+		++ProbesThisStep;
+		++Stats.Probes;
+		INC_DWORD_STAT(STAT_CombatFlowFieldProbes);
+
+		const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+		FNavLocation NavLocation;
+		const FVector Extent(Grid.CellSize * 0.5f, Grid.CellSize * 0.5f, CombatFlowField::ProbeHeight);
+		if (NavSys && NavSys->ProjectPointToNavigation(Grid.GetCellCenter(Cell), NavLocation, Extent))
+		{
+			CellStates[Cell] = ECellState::Walkable;
+			CellHeights[Cell] = NavLocation.Location.Z;
+		}
+	}
+	return CellStates[Cell] == ECellState::Walkable;
+}
+
+bool UCombatFlowFieldSubsystem::CanStep(int32 From, int32 To, int32 Direction)
+{
+	// Steeper than 45 degrees between cell centers is a wall or a ledge
+	if (!IsWalkable(To) || FMath::Abs(CellHeights[To] - CellHeights[From]) > Grid.CellSize)
+	{
+		return false;
+	}
+
+	// No cutting corners past a blocked cell
+	if (Direction & 1)
+	{
+		const FIntPoint& Offset = CombatFlowField::Offsets[Direction];
+		return IsWalkable(From + Offset.X) && IsWalkable(From + Offset.Y * Grid.Size);
+	}
+	return true;
+}
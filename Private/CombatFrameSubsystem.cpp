@@ -0,0 +1,376 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CombatFrameSubsystem.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "GameFramework/Character.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/ScopeLock.h"
+
+DECLARE_STATS_GROUP(TEXT("Combat Pipeline"), STATGROUP_CombatPipeline, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Combat Frame"), STAT_CombatFrame, STATGROUP_CombatPipeline);
+DECLARE_CYCLE_STAT(TEXT("Gather Snapshot"), STAT_CombatGatherSnapshot, STATGROUP_CombatPipeline);
+DECLARE_CYCLE_STAT(TEXT("Perception"), STAT_CombatPerception, STATGROUP_CombatPipeline);
+DECLARE_CYCLE_STAT(TEXT("Decisions"), STAT_CombatDecisions, STATGROUP_CombatPipeline);
+DECLARE_CYCLE_STAT(TEXT("Movement Requests"), STAT_CombatMovementRequests, STATGROUP_CombatPipeline);
+DECLARE_CYCLE_STAT(TEXT("Projectile Sim"), STAT_CombatProjectileSim, STATGROUP_CombatPipeline);
+DECLARE_CYCLE_STAT(TEXT("Damage Resolution"), STAT_CombatDamageResolution, STATGROUP_CombatPipeline);
+DECLARE_CYCLE_STAT(TEXT("Presentation"), STAT_CombatPresentation, STATGROUP_CombatPipeline);
+
+static TAutoConsoleVariable<float> CVarCombatSimRate(
+	TEXT("Combat.Sim.Rate"),
+	60.f,
+	TEXT("Fixed combat simulation rate in Hz. Lower it to run the combat sim cheaper than the render rate."));
+
+static TAutoConsoleVariable<int32> CVarCombatSimMaxSubsteps(
+	TEXT("Combat.Sim.MaxSubsteps"),
+	4,
+	TEXT("Most fixed steps the combat sim runs in one frame. Time beyond that is dropped so a hitch can't snowball."));
+
+static TAutoConsoleVariable<int32> CVarCombatPipelineParallel(
+	TEXT("Combat.Pipeline.Parallel"),
+	1,
+	TEXT("1 lets thread safe combat stages run on worker threads, 0 runs the whole pipeline on the game thread."));
+
+namespace CombatFrame
+{
+	static TStatId GetStageStatId(ECombatFrameStage Stage)
+	{
+		switch (Stage)
+		{
+		case ECombatFrameStage::GatherSnapshot: return GET_STATID(STAT_CombatGatherSnapshot);
+		case ECombatFrameStage::Perception: return GET_STATID(STAT_CombatPerception);
+		case ECombatFrameStage::Decisions: return GET_STATID(STAT_CombatDecisions);
+		case ECombatFrameStage::MovementRequests: return GET_STATID(STAT_CombatMovementRequests);
+		case ECombatFrameStage::ProjectileSim: return GET_STATID(STAT_CombatProjectileSim);
+		case ECombatFrameStage::DamageResolution: return GET_STATID(STAT_CombatDamageResolution);
+		default: return GET_STATID(STAT_CombatPresentation);
+		}
+	}
+
+	// Declared dependencies of each stage. Projectile sim waits for the AI stages that may run on workers,
+	// since its hits change the actor state they read
+	static TArray<ECombatFrameStage, TInlineAllocator<2>> GetStageDependencies(ECombatFrameStage Stage)
+	{
+		switch (Stage)
+		{
+		case ECombatFrameStage::Perception: return { ECombatFrameStage::GatherSnapshot };
+		case ECombatFrameStage::Decisions: return { ECombatFrameStage::Perception };
+		case ECombatFrameStage::MovementRequests: return { ECombatFrameStage::Decisions };
+		case ECombatFrameStage::ProjectileSim: return { ECombatFrameStage::Decisions };
+		case ECombatFrameStage::DamageResolution: return { ECombatFrameStage::MovementRequests, ECombatFrameStage::ProjectileSim };
+		case ECombatFrameStage::Presentation: return { ECombatFrameStage::DamageResolution };
+		default: return {};
+		}
+	}
+}
+
+int32 FCombatSimClock::Advance(float DeltaTime, float FixedStep, int32 MaxSteps)
+{
+	Accumulator += DeltaTime;
+
+	StepsThisFrame = FMath::FloorToInt32(Accumulator / FixedStep);
+	if (StepsThisFrame > MaxSteps)
+	{
+		StepsThisFrame = MaxSteps;
+		Accumulator = FixedStep * MaxSteps;
+	}
+
+	Accumulator -= StepsThisFrame * FixedStep;
+	SimTime += StepsThisFrame * FixedStep;
+	Alpha = static_cast<float>(Accumulator / FixedStep);
+	return StepsThisFrame;
+}
+
+UCombatFrameSubsystem* UCombatFrameSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UCombatFrameSubsystem>() : nullptr;
+}
+
+bool UCombatFrameSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatFrameSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UCombatFrameSubsystem::OnWorldTickStart);
+}
+
+void UCombatFrameSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+
+	for (TArray<FStageWorkItem>& Items : StageWork)
+	{
+		Items.Empty();
+	}
+	PendingAdds.Empty();
+	PendingRemovals.Empty();
+	NumPendingRemovals = 0;
+	Enemies.Empty();
+
+	Super::Deinitialize();
+}
+
+TStatId UCombatFrameSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCombatFrameSubsystem, STATGROUP_Tickables);
+}
+
+void UCombatFrameSubsystem::AddStageWork(ECombatFrameStage Stage, const UObject* Owner, FCombatStageWork Work, bool bThreadSafe)
+{
+	check(IsInGameThread());
+
+	FStageWorkItem Item;
+	Item.Owner = Owner;
+	Item.OwnerKey = Owner;
+	Item.Work = MoveTemp(Work);
+	Item.bThreadSafe = bThreadSafe;
+
+	// Actors spawned from inside a stage join the pipeline on the next frame
+	if (bIsRunningPipeline)
+	{
+		PendingAdds.Add({ Stage, MoveTemp(Item) });
+		return;
+	}
+
+	StageWork[static_cast<int32>(Stage)].Add(MoveTemp(Item));
+}
+
+void UCombatFrameSubsystem::RemoveStageWork(const UObject* Owner)
+{
+	check(IsInGameThread());
+
+	PendingAdds.RemoveAll([Owner](const FPendingStageWork& Pending) { return Pending.Item.Owner.Get() == Owner; });
+
+	if (bIsRunningPipeline)
+	{
+		// Later stages this frame must not call into an owner that has just been torn down, but a worker stage may be
+		// walking its array right now, so queue the removal. An owner may re-register (e.g. a pooled arrow) straight away
+		FScopeLock Lock(&PendingRemovalsLock);
+		PendingRemovals.AddUnique(Owner);
+		NumPendingRemovals = PendingRemovals.Num();
+		return;
+	}
+
+	for (TArray<FStageWorkItem>& Items : StageWork)
+	{
+		Items.RemoveAll([Owner](const FStageWorkItem& Item) { return Item.Owner.Get() == Owner; });
+	}
+}
+
+void UCombatFrameSubsystem::RegisterEnemy(ACharacter* Enemy)
+{
+	Enemies.AddUnique(Enemy);
+}
+
+void UCombatFrameSubsystem::UnregisterEnemy(ACharacter* Enemy)
+{
+	Enemies.Remove(Enemy);
+}
+
+float UCombatFrameSubsystem::GetStageMilliseconds(ECombatFrameStage Stage) const
+{
+	return static_cast<float>(StageMilliseconds[static_cast<int32>(Stage)]);
+}
+
+float UCombatFrameSubsystem::GetFixedStep() const
+{
+	return 1.f / FMath::Max(CVarCombatSimRate.GetValueOnGameThread(), 1.f);
+}
+
+void UCombatFrameSubsystem::OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World != GetWorld())
+	{
+		return;
+	}
+
+	// Nothing ticks while paused, so the sim must not bank that time either
+	if (World->IsPaused())
+	{
+		SimClock.StepsThisFrame = 0;
+		return;
+	}
+
+	const AWorldSettings* WorldSettings = World->GetWorldSettings();
+	const float GameDeltaTime = DeltaSeconds * (WorldSettings ? WorldSettings->GetEffectiveTimeDilation() : 1.f);
+	SimClock.Advance(GameDeltaTime, GetFixedStep(), FMath::Max(CVarCombatSimMaxSubsteps.GetValueOnGameThread(), 1));
+}
+
+void UCombatFrameSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_CombatFrame);
+
+	bIsRunningPipeline = true;
+	FMemory::Memzero(StageMilliseconds);
+
+	// Simulation stages run once per fixed step, presentation once per render frame
+	const float FixedStep = GetFixedStep();
+	for (int32 Step = 0; Step < SimClock.StepsThisFrame; ++Step)
+	{
+		Snapshot.SimTime = SimClock.SimTime - (SimClock.StepsThisFrame - 1 - Step) * FixedStep;
+		const FGraphEventRef StepDone = DispatchStages(ECombatFrameStage::GatherSnapshot, ECombatFrameStage::DamageResolution, FixedStep);
+
+		// Game thread stages are queued on the local game thread queue and get processed while we wait here
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(StepDone, ENamedThreads::GameThread_Local);
+	}
+
+	Snapshot.InterpolationAlpha = SimClock.Alpha;
+	RunStage(ECombatFrameStage::Presentation, DeltaTime);
+
+	bIsRunningPipeline = false;
+	FlushPendingChanges();
+}
+
+FGraphEventRef UCombatFrameSubsystem::DispatchStages(ECombatFrameStage FirstStage, ECombatFrameStage LastStage, float DeltaTime)
+{
+	// Build the step graph. Stage order in the enum is already a valid topological order
+	FGraphEventRef StageEvents[StageCount];
+	for (int32 StageIndex = static_cast<int32>(FirstStage); StageIndex <= static_cast<int32>(LastStage); ++StageIndex)
+	{
+		const ECombatFrameStage Stage = static_cast<ECombatFrameStage>(StageIndex);
+
+		FGraphEventArray Prerequisites;
+		for (const ECombatFrameStage Dependency : CombatFrame::GetStageDependencies(Stage))
+		{
+			if (StageEvents[static_cast<int32>(Dependency)].IsValid())
+			{
+				Prerequisites.Add(StageEvents[static_cast<int32>(Dependency)]);
+			}
+		}
+
+		const ENamedThreads::Type Thread = CanRunOffGameThread(Stage)
+			? ENamedThreads::AnyBackgroundThreadNormalTask
+			: ENamedThreads::GameThread_Local;
+
+		StageEvents[StageIndex] = FFunctionGraphTask::CreateAndDispatchWhenReady(
+			[this, Stage, DeltaTime]()
+			{
+				RunStage(Stage, DeltaTime);
+			},
+			CombatFrame::GetStageStatId(Stage),
+			&Prerequisites,
+			Thread);
+	}
+
+	return StageEvents[static_cast<int32>(LastStage)];
+}
+
+void UCombatFrameSubsystem::RunStage(ECombatFrameStage Stage, float DeltaTime)
+{
+	FScopeCycleCounter CycleCounter(CombatFrame::GetStageStatId(Stage));
+	const double StartTime = FPlatformTime::Seconds();
+
+	if (Stage == ECombatFrameStage::GatherSnapshot)
+	{
+		GatherSnapshot();
+	}
+
+	// Only this stage's task touches its array, so flagging removed owners here is safe from any thread
+	for (FStageWorkItem& Item : StageWork[static_cast<int32>(Stage)])
+	{
+		if (!Item.bRemoved && NumPendingRemovals > 0 && IsRemovalPending(Item.OwnerKey))
+		{
+			Item.bRemoved = true;
+		}
+		if (!Item.bRemoved)
+		{
+			Item.Work(Snapshot, DeltaTime);
+		}
+	}
+
+	StageMilliseconds[static_cast<int32>(Stage)] += (FPlatformTime::Seconds() - StartTime) * 1000.0;
+}
+
+void UCombatFrameSubsystem::GatherSnapshot()
+{
+	Snapshot.FrameNumber = GFrameCounter;
+
+	APawn* PlayerPawn = UGameplayStatics::GetPlayerPawn(GetWorld(), 0);
+	Snapshot.Player = PlayerPawn;
+	Snapshot.PlayerRaw = PlayerPawn;
+	if (PlayerPawn)
+	{
+		Snapshot.PlayerLocation = PlayerPawn->GetActorLocation();
+		Snapshot.PlayerVelocity = PlayerPawn->GetVelocity();
+		Snapshot.PlayerSpeed = Snapshot.PlayerVelocity.Size();
+	}
+
+	Snapshot.Enemies.Reset(Enemies.Num());
+	for (const TWeakObjectPtr<ACharacter>& Enemy : Enemies)
+	{
+		if (const ACharacter* Character = Enemy.Get())
+		{
+			FCombatEnemySnapshot& EnemySnapshot = Snapshot.Enemies.AddDefaulted_GetRef();
+			EnemySnapshot.Character = Enemy;
+			EnemySnapshot.Location = Character->GetActorLocation();
+			EnemySnapshot.DistanceToPlayer = FVector::Dist(EnemySnapshot.Location, Snapshot.PlayerLocation);
+		}
+	}
+}
+
+bool UCombatFrameSubsystem::CanRunOffGameThread(ECombatFrameStage Stage) const
+{
+	if (CVarCombatPipelineParallel.GetValueOnGameThread() == 0
+		|| Stage == ECombatFrameStage::GatherSnapshot
+		|| Stage == ECombatFrameStage::Presentation)
+	{
+		return false;
+	}
+
+	const TArray<FStageWorkItem>& Items = StageWork[static_cast<int32>(Stage)];
+	if (Items.IsEmpty())
+	{
+		return false;
+	}
+
+	for (const FStageWorkItem& Item : Items)
+	{
+		if (!Item.bThreadSafe)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool UCombatFrameSubsystem::IsRemovalPending(const UObject* Owner) const
+{
+	FScopeLock Lock(&PendingRemovalsLock);
+	return PendingRemovals.Contains(Owner);
+}
+
+void UCombatFrameSubsystem::FlushPendingChanges()
+{
+	// Removals first, so an owner that re-registered after being removed keeps its new work
+	if (NumPendingRemovals > 0)
+	{
+		for (TArray<FStageWorkItem>& Items : StageWork)
+		{
+			Items.RemoveAll([this](const FStageWorkItem& Item) { return PendingRemovals.Contains(Item.OwnerKey); });
+		}
+		PendingRemovals.Reset();
+		NumPendingRemovals = 0;
+	}
+
+	for (FPendingStageWork& Pending : PendingAdds)
+	{
+		StageWork[static_cast<int32>(Pending.Stage)].Add(MoveTemp(Pending.Item));
+	}
+	PendingAdds.Reset();
+
+	// Drop work whose owner went away without unregistering
+	for (TArray<FStageWorkItem>& Items : StageWork)
+	{
+		Items.RemoveAll([](const FStageWorkItem& Item) { return Item.bRemoved || !Item.Owner.IsValid(); });
+	}
+	Enemies.RemoveAll([](const TWeakObjectPtr<ACharacter>& Enemy) { return !Enemy.IsValid(); });
+}
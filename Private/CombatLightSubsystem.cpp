@@ -0,0 +1,330 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CombatLightSubsystem.h"
+#include "Camera/PlayerCameraManager.h"
+#include "CombatFrameSubsystem.h"
+#include "Components/PointLightComponent.h"
+#include "Components/SpotLightComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_STATS_GROUP(TEXT("Combat Lights"), STATGROUP_CombatLights, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Update Lights"), STAT_CombatLightsUpdate, STATGROUP_CombatLights);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active"), STAT_CombatLightsActive, STATGROUP_CombatLights);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Waiting"), STAT_CombatLightsWaiting, STATGROUP_CombatLights);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Intensity Updates"), STAT_CombatLightsIntensityUpdates, STATGROUP_CombatLights);
+
+static TAutoConsoleVariable<int32> CVarCombatLightsMaxActive(
+	TEXT("Combat.Lights.MaxActive"),
+	6,
+	TEXT("Most gameplay lights lit at once. Lower priority and further requests wait for a free light."));
+
+static TAutoConsoleVariable<float> CVarCombatLightsIntensityStep(
+	TEXT("Combat.Lights.IntensityStep"),
+	0.02f,
+	TEXT("Smallest fade change, as a fraction of the requested intensity, that is pushed to the renderer."));
+
+namespace CombatLight
+{
+	static FTransform GetWorldTransform(const FCombatLightRequest& Request)
+	{
+		const FTransform Transform(Request.Rotation, Request.Location);
+		return Request.AttachTo.IsValid() ? Transform * Request.AttachTo->GetComponentTransform() : Transform;
+	}
+}
+
+FCombatLightRequest FCombatLightRequest::FromTemplate(ULocalLightComponent* Template, ECombatLightPriority Priority)
+{
+	FCombatLightRequest Request;
+	Request.Priority = Priority;
+	if (!Template)
+	{
+		return Request;
+	}
+
+	Request.AttachTo = Template;
+	Request.Color = Template->GetLightColor();
+	Request.Intensity = Template->Intensity;
+	Request.IntensityUnits = Template->IntensityUnits;
+	Request.AttenuationRadius = Template->AttenuationRadius;
+	Request.bCastShadows = Template->CastShadows;
+	if (const USpotLightComponent* Spot = Cast<USpotLightComponent>(Template))
+	{
+		Request.Type = ECombatLightType::Spot;
+		Request.InnerConeAngle = Spot->InnerConeAngle;
+		Request.OuterConeAngle = Spot->OuterConeAngle;
+	}
+	return Request;
+}
+
+UCombatLightSubsystem* UCombatLightSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UCombatLightSubsystem>() : nullptr;
+}
+
+FCombatLightHandle UCombatLightSubsystem::RequestLight(const UObject* WorldContextObject, const FCombatLightRequest& Request)
+{
+	UCombatLightSubsystem* CombatLights = Get(WorldContextObject);
+	return CombatLights ? CombatLights->Request(Request) : FCombatLightHandle();
+}
+
+void UCombatLightSubsystem::ReleaseLight(const UObject* WorldContextObject, FCombatLightHandle& Handle, bool bImmediate)
+{
+	if (UCombatLightSubsystem* CombatLights = Get(WorldContextObject))
+	{
+		CombatLights->Release(Handle, bImmediate);
+	}
+	Handle = FCombatLightHandle();
+}
+
+bool UCombatLightSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatLightSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (UCombatFrameSubsystem* CombatFrame = UCombatFrameSubsystem::Get(this))
+	{
+		CombatFrame->AddStageWork(ECombatFrameStage::Presentation, this,
+			[this](const FCombatSnapshot&, float) { UpdateLights(); });
+	}
+}
+
+void UCombatLightSubsystem::Deinitialize()
+{
+	if (UCombatFrameSubsystem* CombatFrame = UCombatFrameSubsystem::Get(this))
+	{
+		CombatFrame->RemoveStageWork(this);
+	}
+
+	// The components themselves go away with the world settings actor
+	Requests.Empty();
+	Lights.Empty();
+
+	Super::Deinitialize();
+}
+
+FCombatLightHandle UCombatLightSubsystem::Request(const FCombatLightRequest& Request)
+{
+	FLiveRequest& Live = Requests.AddDefaulted_GetRef();
+	Live.Handle.Id = NextId++;
+	Live.Request = Request;
+	Live.StartTime = GetWorld()->GetTimeSeconds();
+	++Stats.Requested;
+	return Live.Handle;
+}
+
+void UCombatLightSubsystem::Release(FCombatLightHandle& Handle, bool bImmediate)
+{
+	const int32 Index = Requests.IndexOfByPredicate([&Handle](const FLiveRequest& Live) { return Live.Handle.Id == Handle.Id; });
+	Handle = FCombatLightHandle();
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	FLiveRequest& Live = Requests[Index];
+	if (bImmediate || Live.Request.FadeOut <= 0.f)
+	{
+		FreeLight(Live);
+		Requests.RemoveAtSwap(Index);
+	}
+	else if (Live.ReleaseTime < 0.0)
+	{
+		Live.ReleaseTime = GetWorld()->GetTimeSeconds();
+	}
+}
+
+void UCombatLightSubsystem::UpdateLights()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CombatLightsUpdate);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	const APlayerCameraManager* Camera = UGameplayStatics::GetPlayerCameraManager(this, 0);
+
+	for (int32 Index = Requests.Num() - 1; Index >= 0; --Index)
+	{
+		FLiveRequest& Live = Requests[Index];
+		const FCombatLightRequest& Request = Live.Request;
+		if (Live.ReleaseTime < 0.0 && Request.Duration > 0.f && Now - Live.StartTime >= Request.Duration)
+		{
+			Live.ReleaseTime = Live.StartTime + Request.Duration;
+		}
+
+		// A light that followed something gone, or has fully faded, is done
+		const bool bLostAttachment = !Request.AttachTo.IsExplicitlyNull() && !Request.AttachTo.IsValid();
+		if (bLostAttachment || (Live.ReleaseTime >= 0.0 && Now - Live.ReleaseTime >= Request.FadeOut))
+		{
+			FreeLight(Live);
+			Requests.RemoveAtSwap(Index);
+			continue;
+		}
+
+		// Priority always wins; within a priority the closest to the camera gets a light first
+		const float Distance = Camera ? FVector::Dist(CombatLight::GetWorldTransform(Request).GetLocation(), Camera->GetCameraLocation()) : 0.f;
+		Live.Score = static_cast<float>(Request.Priority) * 1.0e7f - Distance;
+	}
+
+	Requests.Sort([](const FLiveRequest& A, const FLiveRequest& B) { return A.Score > B.Score; });
+
+	// Requests past the budget hand their lights back first so the ones above them can take them
+	const int32 MaxActive = FMath::Max(CVarCombatLightsMaxActive.GetValueOnGameThread(), 0);
+	for (int32 Index = MaxActive; Index < Requests.Num(); ++Index)
+	{
+		FreeLight(Requests[Index]);
+	}
+
+	Stats.Active = 0;
+	for (int32 Index = 0; Index < FMath::Min(MaxActive, Requests.Num()); ++Index)
+	{
+		FLiveRequest& Live = Requests[Index];
+		const bool bNewlyLit = Live.LightIndex == INDEX_NONE;
+		if (bNewlyLit)
+		{
+			Live.LightIndex = AcquireLight(Live.Request.Type);
+			if (Live.LightIndex == INDEX_NONE)
+			{
+				continue;
+			}
+			Live.AppliedIntensity = -1.f;
+		}
+
+		ULocalLightComponent* Light = Lights[Live.LightIndex].Component.Get();
+		if (bNewlyLit)
+		{
+			ApplyRequest(Live, Light);
+		}
+		else if (Live.Request.AttachTo.IsValid())
+		{
+			const FTransform Transform = CombatLight::GetWorldTransform(Live.Request);
+			Light->SetWorldLocationAndRotation(Transform.GetLocation(), Transform.GetRotation());
+		}
+
+		// Fades only reach the renderer once they have moved far enough to see
+		const float Intensity = GetFadedIntensity(Live, Now);
+		const float Step = CVarCombatLightsIntensityStep.GetValueOnGameThread() * Live.Request.Intensity;
+		if (FMath::Abs(Intensity - Live.AppliedIntensity) > Step || (Intensity == 0.f && Live.AppliedIntensity != 0.f))
+		{
+			Light->SetIntensity(Intensity);
+			Live.AppliedIntensity = Intensity;
+			++Stats.IntensityUpdates;
+			INC_DWORD_STAT(STAT_CombatLightsIntensityUpdates);
+		}
+		++Stats.Active;
+	}
+
+	Stats.Waiting = Requests.Num() - Stats.Active;
+	SET_DWORD_STAT(STAT_CombatLightsActive, Stats.Active);
+	SET_DWORD_STAT(STAT_CombatLightsWaiting, Stats.Waiting);
+}
+
+float UCombatLightSubsystem::GetFadedIntensity(const FLiveRequest& Live, double Now) const
+{
+	const FCombatLightRequest& Request = Live.Request;
+	float Scale = Request.FadeIn > 0.f ? FMath::Clamp(static_cast<float>(Now - Live.StartTime) / Request.FadeIn, 0.f, 1.f) : 1.f;
+	if (Live.ReleaseTime >= 0.0)
+	{
+		Scale *= Request.FadeOut > 0.f ? FMath::Clamp(1.f - static_cast<float>(Now - Live.ReleaseTime) / Request.FadeOut, 0.f, 1.f) : 0.f;
+	}
+	return Request.Intensity * Scale;
+}
+
+int32 UCombatLightSubsystem::AcquireLight(ECombatLightType Type)
+{
+	int32 TypeCount = 0;
+	for (int32 Index = 0; Index < Lights.Num(); ++Index)
+	{
+		FPooledLight& Pooled = Lights[Index];
+		if (Pooled.Type != Type)
+		{
+			continue;
+		}
+
+		++TypeCount;
+		if (!Pooled.bAssigned)
+		{
+			// Lights go away with the world settings actor on a level change
+			if (!Pooled.Component.IsValid())
+			{
+				Pooled.Component = CreateLight(Type);
+			}
+			if (Pooled.Component.IsValid())
+			{
+				Pooled.bAssigned = true;
+				return Index;
+			}
+		}
+	}
+
+	// Either kind may take the whole budget, so the pool holds up to that many of each
+	if (TypeCount >= CVarCombatLightsMaxActive.GetValueOnGameThread())
+	{
+		return INDEX_NONE;
+	}
+
+	ULocalLightComponent* Component = CreateLight(Type);
+	if (!Component)
+	{
+		return INDEX_NONE;
+	}
+	return Lights.Add({ Component, Type, true });
+}
+
+ULocalLightComponent* UCombatLightSubsystem::CreateLight(ECombatLightType Type)
+{
+	UWorld* World = GetWorld();
+	AWorldSettings* WorldSettings = World ? World->GetWorldSettings() : nullptr;
+	if (!WorldSettings)
+	{
+		return nullptr;
+	}
+
+	// Owned by the world settings so the lights live as long as the level
+	ULocalLightComponent* Light = Type == ECombatLightType::Spot
+		? static_cast<ULocalLightComponent*>(NewObject<USpotLightComponent>(WorldSettings))
+		: static_cast<ULocalLightComponent*>(NewObject<UPointLightComponent>(WorldSettings));
+	Light->SetMobility(EComponentMobility::Movable);
+	Light->SetVisibility(false);
+	Light->RegisterComponentWithWorld(World);
+	return Light;
+}
+
+void UCombatLightSubsystem::ApplyRequest(FLiveRequest& Live, ULocalLightComponent* Light)
+{
+	const FCombatLightRequest& Request = Live.Request;
+	const FTransform Transform = CombatLight::GetWorldTransform(Request);
+
+	Light->SetWorldLocationAndRotation(Transform.GetLocation(), Transform.GetRotation());
+	Light->SetLightColor(Request.Color);
+	Light->SetIntensityUnits(Request.IntensityUnits);
+	Light->SetAttenuationRadius(Request.AttenuationRadius);
+	Light->SetCastShadows(Request.bCastShadows);
+	if (USpotLightComponent* Spot = Cast<USpotLightComponent>(Light))
+	{
+		Spot->SetInnerConeAngle(Request.InnerConeAngle);
+		Spot->SetOuterConeAngle(Request.OuterConeAngle);
+	}
+	Light->SetVisibility(true);
+}
+
+void UCombatLightSubsystem::FreeLight(FLiveRequest& Live)
+{
+	if (Live.LightIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	FPooledLight& Pooled = Lights[Live.LightIndex];
+	if (ULocalLightComponent* Light = Pooled.Component.Get())
+	{
+		Light->SetVisibility(false);
+	}
+	Pooled.bAssigned = false;
+	Live.LightIndex = INDEX_NONE;
+}
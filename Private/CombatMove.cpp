@@ -0,0 +1,247 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CombatMove.h"
+#include "Engine/World.h"
+
+FCombatMove& FCombatMove::Reset()
+{
+	Cancel();
+	Steps.Reset();
+	FinallyHandler = nullptr;
+	PendingCondition = nullptr;
+	Cursor = 0;
+	return *this;
+}
+
+FCombatMove& FCombatMove::Then(TFunction<void()> Action)
+{
+	FStep& Step = Steps.AddDefaulted_GetRef();
+	Step.Type = EStepType::Action;
+	Step.Action = MoveTemp(Action);
+	return *this;
+}
+
+FCombatMove& FCombatMove::ContinueIf(TFunction<bool()> Condition)
+{
+	FStep& Step = Steps.AddDefaulted_GetRef();
+	Step.Type = EStepType::Guard;
+	Step.Condition = MoveTemp(Condition);
+	return *this;
+}
+
+FCombatMove& FCombatMove::Wait(float Seconds)
+{
+	FStep& Step = Steps.AddDefaulted_GetRef();
+	Step.Type = EStepType::Delay;
+	Step.Seconds = Seconds;
+	return *this;
+}
+
+FCombatMove& FCombatMove::WaitUntil(TFunction<bool()> Condition, float Timeout)
+{
+	FStep& Step = Steps.AddDefaulted_GetRef();
+	Step.Type = EStepType::Condition;
+	Step.Condition = MoveTemp(Condition);
+	Step.Seconds = Timeout;
+	return *this;
+}
+
+FCombatMove& FCombatMove::Finally(TFunction<void(bool bWasCancelled)> Handler)
+{
+	FinallyHandler = MoveTemp(Handler);
+	return *this;
+}
+
+void FCombatMove::Start(UObject* InOwner)
+{
+	Owner = InOwner;
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	Cursor = 0;
+	StartTime = World->GetTimeSeconds();
+	bIsRunning = true;
+	Advance();
+}
+
+void FCombatMove::Cancel()
+{
+	if (bIsRunning)
+	{
+		Finish(true);
+	}
+}
+
+float FCombatMove::GetElapsedTime() const
+{
+	const UWorld* World = GetWorld();
+	return (bIsRunning && World) ? static_cast<float>(World->GetTimeSeconds() - StartTime) : 0.f;
+}
+
+void FCombatMove::Advance()
+{
+	// A step may cancel or rebuild this move (e.g. an action that triggers EnterDamageState),
+	// so every step is moved out before it runs and the generation is checked afterwards
+	const uint32 RunGeneration = Generation;
+
+	while (bIsRunning && Generation == RunGeneration && Cursor < Steps.Num())
+	{
+		FStep& Step = Steps[Cursor++];
+		switch (Step.Type)
+		{
+		case EStepType::Action:
+			{
+				TFunction<void()> Action = MoveTemp(Step.Action);
+				if (Action)
+				{
+					Action();
+				}
+				break;
+			}
+		case EStepType::Guard:
+			{
+				TFunction<bool()> Condition = MoveTemp(Step.Condition);
+				if (Condition && !Condition())
+				{
+					if (bIsRunning && Generation == RunGeneration)
+					{
+						Finish(false);
+					}
+					return;
+				}
+				break;
+			}
+		case EStepType::Delay:
+			ScheduleDelay(Step.Seconds);
+			return;
+		case EStepType::Condition:
+			{
+				// The condition may rebuild the step array, so nothing is read through Step once it has run,
+				// and it may cancel the move, so it runs from a local rather than from PendingCondition
+				const float Timeout = Step.Seconds;
+				TFunction<bool()> Condition = MoveTemp(Step.Condition);
+				const bool bMet = !Condition || Condition();
+				if (!bIsRunning || Generation != RunGeneration)
+				{
+					return;
+				}
+				if (!bMet)
+				{
+					PendingCondition = MoveTemp(Condition);
+					const UWorld* World = GetWorld();
+					PendingTimeoutAt = (Timeout > 0.f && World) ? World->GetTimeSeconds() + Timeout : -1.0;
+					SchedulePoll();
+					return;
+				}
+				break;
+			}
+		}
+	}
+
+	if (bIsRunning && Generation == RunGeneration)
+	{
+		Finish(false);
+	}
+}
+
+void FCombatMove::Finish(bool bWasCancelled)
+{
+	bIsRunning = false;
+	++Generation;
+	PendingCondition = nullptr;
+
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(WaitTimerHandle);
+	}
+
+	TFunction<void(bool)> Handler = MoveTemp(FinallyHandler);
+	if (Handler)
+	{
+		Handler(bWasCancelled);
+	}
+}
+
+void FCombatMove::ScheduleDelay(float Seconds)
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		Finish(true);
+		return;
+	}
+
+	const uint32 ExpectedGeneration = Generation;
+	FTimerDelegate Delegate = FTimerDelegate::CreateWeakLambda(Owner.Get(), [this, ExpectedGeneration]()
+	{
+		if (bIsRunning && Generation == ExpectedGeneration)
+		{
+			Advance();
+		}
+	});
+
+	if (Seconds > 0.f)
+	{
+		World->GetTimerManager().SetTimer(WaitTimerHandle, Delegate, Seconds, false);
+	}
+	else
+	{
+		WaitTimerHandle = World->GetTimerManager().SetTimerForNextTick(Delegate);
+	}
+}
+
+void FCombatMove::SchedulePoll()
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		Finish(true);
+		return;
+	}
+
+	const uint32 ExpectedGeneration = Generation;
+	WaitTimerHandle = World->GetTimerManager().SetTimerForNextTick(
+		FTimerDelegate::CreateWeakLambda(Owner.Get(), [this, ExpectedGeneration]()
+		{
+			PollCondition(ExpectedGeneration);
+		}));
+}
+
+void FCombatMove::PollCondition(uint32 ExpectedGeneration)
+{
+	if (!bIsRunning || Generation != ExpectedGeneration)
+	{
+		return;
+	}
+
+	// Cancelling from inside the condition clears PendingCondition, so it must not be running from there
+	TFunction<bool()> Condition = MoveTemp(PendingCondition);
+	PendingCondition = nullptr;
+
+	const UWorld* World = GetWorld();
+	const bool bTimedOut = PendingTimeoutAt >= 0.0 && World && World->GetTimeSeconds() >= PendingTimeoutAt;
+	const bool bMet = bTimedOut || !Condition || Condition();
+	if (!bIsRunning || Generation != ExpectedGeneration)
+	{
+		return;
+	}
+
+	if (bMet)
+	{
+		PendingTimeoutAt = -1.0;
+		Advance();
+		return;
+	}
+
+	PendingCondition = MoveTemp(Condition);
+	SchedulePoll();
+}
+
+UWorld* FCombatMove::GetWorld() const
+{
+	const UObject* OwnerObject = Owner.Get();
+	return OwnerObject ? OwnerObject->GetWorld() : nullptr;
+}
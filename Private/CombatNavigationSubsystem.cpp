@@ -0,0 +1,164 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CombatNavigationSubsystem.h"
+#include "AIController.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "NavigationData.h"
+
+DECLARE_STATS_GROUP(TEXT("Combat Navigation"), STATGROUP_CombatNavigation, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Moves Issued"), STAT_CombatNavIssued, STATGROUP_CombatNavigation);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Repaths"), STAT_CombatNavRepaths, STATGROUP_CombatNavigation);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Moves Suppressed"), STAT_CombatNavSuppressed, STATGROUP_CombatNavigation);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Stops Issued"), STAT_CombatNavStopsIssued, STATGROUP_CombatNavigation);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Stops Suppressed"), STAT_CombatNavStopsSuppressed, STATGROUP_CombatNavigation);
+
+static TAutoConsoleVariable<float> CVarCombatNavRepathDistance(
+	TEXT("Combat.Nav.RepathDistance"),
+	100.f,
+	TEXT("How far a move's goal actor has to move before a repeated request for it asks for a new path. 0 repaths on every request."));
+
+UCombatNavigationSubsystem* UCombatNavigationSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UCombatNavigationSubsystem>() : nullptr;
+}
+
+void UCombatNavigationSubsystem::MoveToActor(AAIController* Controller, AActor* Goal, float AcceptanceRadius, bool bCanStrafe)
+{
+	if (!Controller || !Goal)
+	{
+		return;
+	}
+
+	if (UCombatNavigationSubsystem* Navigation = Get(Controller))
+	{
+		Navigation->RequestMove(Controller, Goal, AcceptanceRadius, bCanStrafe);
+	}
+	else
+	{
+		IssueMove(Controller, Goal, AcceptanceRadius, bCanStrafe);
+	}
+}
+
+void UCombatNavigationSubsystem::StopMovement(AAIController* Controller)
+{
+	if (!Controller)
+	{
+		return;
+	}
+
+	if (UCombatNavigationSubsystem* Navigation = Get(Controller))
+	{
+		Navigation->RequestStop(Controller);
+	}
+	else
+	{
+		Controller->StopMovement();
+	}
+}
+
+bool UCombatNavigationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCombatNavigationSubsystem::Deinitialize()
+{
+	ActiveMoves.Empty();
+
+	Super::Deinitialize();
+}
+
+void UCombatNavigationSubsystem::RequestMove(AAIController* Controller, AActor* Goal, float AcceptanceRadius, bool bCanStrafe)
+{
+	FActiveMove* Active = ActiveMoves.Find(Controller);
+	const bool bSameGoal = Active && Active->Goal == Goal && Active->AcceptanceRadius == AcceptanceRadius && Active->bCanStrafe == bCanStrafe;
+	if (bSameGoal && IsStillValid(*Active, *Controller))
+	{
+		++Stats.Suppressed;
+		INC_DWORD_STAT(STAT_CombatNavSuppressed);
+		return;
+	}
+
+	if (!Active)
+	{
+		// New controllers are rare, so that's when the ones that went away are dropped
+		for (auto It = ActiveMoves.CreateIterator(); It; ++It)
+		{
+			if (!It->Key.IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+		Active = &ActiveMoves.Add(Controller);
+	}
+
+	const EPathFollowingRequestResult::Type Result = IssueMove(Controller, Goal, AcceptanceRadius, bCanStrafe);
+	++Stats.Issued;
+	INC_DWORD_STAT(STAT_CombatNavIssued);
+	if (bSameGoal)
+	{
+		++Stats.Repaths;
+		INC_DWORD_STAT(STAT_CombatNavRepaths);
+	}
+
+	Active->Goal = Goal;
+	Active->GoalLocation = Goal->GetActorLocation();
+	Active->AcceptanceRadius = AcceptanceRadius;
+	Active->bCanStrafe = bCanStrafe;
+	Active->RequestId = Result == EPathFollowingRequestResult::RequestSuccessful ? Controller->GetCurrentMoveRequestID() : FAIRequestID::InvalidRequest;
+	Active->bAlreadyAtGoal = Result == EPathFollowingRequestResult::AlreadyAtGoal;
+}
+
+void UCombatNavigationSubsystem::RequestStop(AAIController* Controller)
+{
+	const bool bHadMove = ActiveMoves.Remove(Controller) > 0;
+	if (!bHadMove && Controller->GetMoveStatus() == EPathFollowingStatus::Idle)
+	{
+		++Stats.StopsSuppressed;
+		INC_DWORD_STAT(STAT_CombatNavStopsSuppressed);
+		return;
+	}
+
+	Controller->StopMovement();
+	++Stats.StopsIssued;
+	INC_DWORD_STAT(STAT_CombatNavStopsIssued);
+}
+
+bool UCombatNavigationSubsystem::IsStillValid(const FActiveMove& Move, const AAIController& Controller) const
+{
+	const AActor* Goal = Move.Goal.Get();
+	if (!Goal)
+	{
+		return false;
+	}
+
+	const float RepathDistance = CVarCombatNavRepathDistance.GetValueOnGameThread();
+	if (RepathDistance <= 0.f || FVector::DistSquared(Goal->GetActorLocation(), Move.GoalLocation) > FMath::Square(RepathDistance))
+	{
+		return false;
+	}
+
+	// Standing at a goal that hasn't moved needs no new path either
+	if (Move.bAlreadyAtGoal)
+	{
+		return true;
+	}
+
+	// The move must still be the one we asked for, still running, on a path navigation hasn't invalidated
+	const UPathFollowingComponent* PathFollowing = Controller.GetPathFollowingComponent();
+	if (!PathFollowing || PathFollowing->GetStatus() == EPathFollowingStatus::Idle || PathFollowing->GetCurrentRequestId() != Move.RequestId)
+	{
+		return false;
+	}
+
+	const FNavPathSharedPtr& Path = PathFollowing->GetPath();
+	return Path.IsValid() && Path->IsValid();
+}
+
+EPathFollowingRequestResult::Type UCombatNavigationSubsystem::IssueMove(AAIController* Controller, AActor* Goal, float AcceptanceRadius, bool bCanStrafe)
+{
+	// Same options every AI used before: stop on overlap, pathfinding, default filter, partial paths allowed
+	return Controller->MoveToActor(Goal, AcceptanceRadius, true, true, bCanStrafe, nullptr, true);
+}
@@ -5,20 +5,18 @@
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 
-#include "Elite_ChainProjectile.h"
-#include "AI_Elite.h"
-#include "GameFramework/Character.h"
-#include "Kismet/GameplayStatics.h"
-#include "Components/CapsuleComponent.h"
-#include "GameFramework/CharacterMovementComponent.h"
-
 AElite_ChainProjectile::AElite_ChainProjectile()
 {
-    PrimaryActorTick.bCanEverTick = true;
+    // The tether drives the chain, so the actor itself never ticks
+    PrimaryActorTick.bCanEverTick = false;
+
+    Tether = CreateDefaultSubobject<UTetherComponent>(TEXT("Tether"));
 
     // Initialize variables
     ChainSpeed = 30.f;
-    MaxChainLength = 5.f;
+    MaxChainLength = 12.f;
+    PullForce = 500.f;
+    ChainUnitLength = 100.f;
 }
 
 void AElite_ChainProjectile::BeginPlay()
@@ -43,66 +41,55 @@ void AElite_ChainProjectile::BeginPlay()
         UE_LOG(LogTemp, Error, TEXT("CollisionCapsule component not found!"));
     }
 
-    CurrentChainLength = 0.0f;
     this->SetActorScale3D(FVector(.2, 0.2f, .2f));
+
+    // Chain speed and length are in chain mesh units
+    Tether->ExtendSpeed = ChainSpeed * ChainUnitLength;
+    Tether->RetractSpeed = Tether->ExtendSpeed;
+    Tether->MaxLength = MaxChainLength * ChainUnitLength;
+    Tether->PullStrength = PullForce;
+    Tether->OnTetherUpdated.AddUObject(this, &AElite_ChainProjectile::UpdateChain);
+    Tether->OnStateChanged.AddDynamic(this, &AElite_ChainProjectile::OnTetherStateChanged);
 }
 
-void AElite_ChainProjectile::Tick(float DeltaTime)
+void AElite_ChainProjectile::UpdateChain(const UTetherComponent& UpdatedTether)
 {
-    Super::Tick(DeltaTime);
+    FRotator NewRotation = UpdatedTether.GetDirection().Rotation() - FRotator(90.f, 0.f, 90.f);
+    SetActorLocationAndRotation(UpdatedTether.GetSourceLocation(), NewRotation);
 
-    // Calculate the distance to target
-    float DistanceToTarget = FVector::Dist(LeftHandLocation, TargetRef->GetActorLocation());
-    
-    LeftHandLocation = BossReference->GetMesh()->GetSocketLocation(FName("LeftHandSocket"));
-    this->SetActorLocation(LeftHandLocation);
-
-    FVector Direction = (TargetRef->GetActorLocation() - LeftHandLocation).GetSafeNormal();
-    FRotator NewRotation = Direction.Rotation() - FRotator(90.f, 0.f, 90.f);
-    this->SetActorRotation(NewRotation);
-
-    // If the chain hasn't reached the target, extend it
-    if (CurrentChainLength < DistanceToTarget && CurrentChainLength < MaxChainLength)
+    // Only touch the mesh scale when the length actually changed
+    const float ChainScale = UpdatedTether.GetLength() / ChainUnitLength;
+    if (ChainMesh && !FMath::IsNearlyEqual(ChainScale, LastChainScale, 0.01f))
     {
-        CurrentChainLength += ChainSpeed * DeltaTime;
+        LastChainScale = ChainScale;
+        ChainMesh->SetWorldScale3D(FVector(.4f, ChainScale, .4f));  // You can adjust the scaling factors as needed
     }
-
-    // Clamp the chain length to make sure it doesn't exceed the target distance or max length
-    CurrentChainLength = FMath::Clamp(CurrentChainLength, 0.f, FMath::Min(DistanceToTarget, MaxChainLength));
-
-    // Set the chain's mesh scale based on the current length
-    ChainMesh->SetWorldScale3D(FVector(.4f, CurrentChainLength, .4f));  // You can adjust the scaling factors as needed
 }
 
-void AElite_ChainProjectile::LaunchChain(APawn* Target, AAI_Elite* Boss)
+void AElite_ChainProjectile::OnTetherStateChanged(ETetherState NewState)
 {
-    BossReference = Boss;
-    TargetRef = Target;
-    CurrentChainLength = 0.f;
-    bIsRetracting = false;
-
-    // Set initial position to the boss's left hand socket
-    if (BossReference)
+    // Fully retracted (or never got going): the chain is done
+    if (NewState == ETetherState::Idle)
     {
-        SetActorLocation(BossReference->GetMesh()->GetSocketLocation(FName("LeftHandSocket")));
+        Destroy();
     }
-
-    GetWorldTimerManager().SetTimer(
-        ChainTimerHandle,
-        [this]()
-        {
-            Destroy();
-        },
-        2.f,
-        false
-    );
 }
 
-void AElite_ChainProjectile::PullPlayer(ACharacter* PlayerCharacter)
+void AElite_ChainProjectile::LaunchChain(APawn* Target, AAI_Elite* Boss)
 {
-    if (PlayerCharacter && BossReference)
+    if (!Boss)
     {
-        FVector PullDirection = (BossReference->GetActorLocation() - PlayerCharacter->GetActorLocation()).GetSafeNormal();
-        PlayerCharacter->GetCharacterMovement()->AddImpulse(PullDirection * PullForce, true);
+        Destroy();
+        return;
     }
-}
\ No newline at end of file
+
+    Tether->Fire(Boss->GetMesh(), FName("LeftHandSocket"), Target);
+    if (Tether->GetState() == ETetherState::Idle)
+    {
+        Destroy();
+        return;
+    }
+
+    // Set initial position to the boss's left hand socket
+    SetActorLocation(Tether->GetSourceLocation());
+}
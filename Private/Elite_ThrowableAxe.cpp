@@ -1,7 +1,8 @@
 #include "Elite_ThrowableAxe.h"
 
-#include "NiagaraFunctionLibrary.h"
+#include "NiagaraComponent.h"
 #include "Engine/DamageEvents.h"
+#include "Components/CapsuleComponent.h"
 #include "GameFramework/Character.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Kismet/GameplayStatics.h"
@@ -17,6 +18,12 @@ AElite_ThrowableAxe::AElite_ThrowableAxe()
 	AxeMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("AxeMesh"));
 	RootComponent = AxeMesh;
 
+	// Single trail for the whole flight instead of spawning a system every tick
+	TrailComponent = CreateDefaultSubobject<UNiagaraComponent>(TEXT("TrailComponent"));
+	TrailComponent->SetupAttachment(AxeMesh);
+	TrailComponent->bAutoActivate = false;
+	TrailComponent->SetAutoDestroy(false);
+
 	// Enable collision and ignore the boss
 	//AxeMesh->SetCollisionProfileName(TEXT("BlockAll"));
 //	AxeMesh->SetGenerateOverlapEvents(true);
@@ -87,38 +94,34 @@ void AElite_ThrowableAxe::BeginPlay()
 	// Rotate the axe 90 degrees forward so it lays flat
 	FRotator MidWay = FRotator(0.0f, 0.0f, -90.0f);
 	AxeMesh->SetWorldRotation(MidWay);
+
+	if (Effect)
+	{
+		TrailComponent->SetAsset(Effect);
+	}
 }
 
 void AElite_ThrowableAxe::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	UNiagaraFunctionLibrary::SpawnSystemAtLocation(
-			GetWorld(),    // Get world context
-			Effect,     // Niagara system to spawn
-			this->GetActorLocation(),   // Location of the hit
-			this->GetActorRotation()    // Rotation to align with surface
-		);
-
-	// Calculate the rotation around the Center
-	float ElapsedTime = GetWorld()->GetTimeSeconds() - ThrowStartTime;
-	float RotationAngle = 300.0f * DeltaTime; // Use DeltaTime for consistent rotation speed
-
-	// Calculate the new position
-	FVector RotationAxis = FVector::UpVector; // Rotate around the Z-axis
-	FVector CurrentPosition = GetActorLocation();
-	FVector RelativePosition = CurrentPosition - Center;
-	FVector NewRelativePosition = RelativePosition.RotateAngleAxis(RotationAngle, RotationAxis);
-	FVector NewPosition = Center + NewRelativePosition.GetSafeNormal() * Radius;
+	// The path is a closed-form function of time since the throw, so a long frame just samples further along it
+	const float ElapsedTime = GetWorld()->GetTimeSeconds() - ThrowStartTime;
+	const FVector PreviousPosition = GetActorLocation();
+	const FVector NewPosition = EvaluatePath(ElapsedTime);
 
 	// Set the new position
 	SetActorLocation(NewPosition);
 
-	if (FVector::Dist(this->GetActorLocation(), BossReference->GetActorLocation()) <= 300.0f && ElapsedTime >= .5f)
+	// Hit test the whole segment travelled this frame so a spike can't carry the axe through the player
+	HitPlayer(PreviousPosition, NewPosition);
+
+	const bool bBackAtBoss = IsValid(BossReference) && FVector::DistSquared(NewPosition, BossReference->GetActorLocation()) <= FMath::Square(300.0f);
+	if ((bBackAtBoss && ElapsedTime >= .5f) || ElapsedTime >= GetLoopDuration())
 	{
 		Destroy();
+		return;
 	}
-	HitPlayer();
     
 	// Make the axe spin
 	AxeMesh->AddLocalRotation(FRotator(SpinSpeed * DeltaTime, 0.0f, 0.0f));
@@ -137,6 +140,9 @@ void AElite_ThrowableAxe::ThrowAxe(FVector TargetLocation, AActor* Boss, AActor*
 	// Calculate the radius of the circular path
 	Radius = (EndLocation - BossReference->GetActorLocation()).Size() * 0.5f;
 
+	// The path starts where the axe is released, projected onto the circle
+	PathStartOffset = (GetActorLocation() - Center).GetSafeNormal() * Radius;
+
 	// Set up collision
 	// AxeMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
 	// AxeMesh->SetCollisionObjectType(ECC_WorldDynamic);
@@ -149,11 +155,46 @@ void AElite_ThrowableAxe::ThrowAxe(FVector TargetLocation, AActor* Boss, AActor*
 	{
 		AxeMesh->IgnoreActorWhenMoving(BossReference, true);
 	}
+
+	if (TrailComponent->GetAsset())
+	{
+		TrailComponent->Activate(true);
+	}
+}
+
+FVector AElite_ThrowableAxe::EvaluatePath(float TimeSinceThrow) const
+{
+	return Center + PathStartOffset.RotateAngleAxis(AngularSpeed * TimeSinceThrow, FVector::UpVector);
+}
+
+float AElite_ThrowableAxe::GetLoopDuration() const
+{
+	return AngularSpeed > 0.f ? 360.f / AngularSpeed : 0.f;
 }
 
-void AElite_ThrowableAxe::HitPlayer()
+void AElite_ThrowableAxe::HitPlayer(const FVector& From, const FVector& To)
 {
-	if (FVector::Dist(this->GetActorLocation(), Player->GetActorLocation()) <= 150.0f)
+	if (!Player || bHasAppliedDamageInCurrentAttack)
+	{
+		return;
+	}
+
+	// Swept sphere against the player's capsule: compare the closest distance between the travelled segment and the capsule axis
+	float CapsuleRadius = 0.f;
+	float CapsuleHalfHeight = 0.f;
+	const ACharacter* PlayerAsCharacter = Cast<ACharacter>(Player);
+	if (PlayerAsCharacter && PlayerAsCharacter->GetCapsuleComponent())
+	{
+		PlayerAsCharacter->GetCapsuleComponent()->GetScaledCapsuleSize(CapsuleRadius, CapsuleHalfHeight);
+	}
+
+	const FVector PlayerLocation = Player->GetActorLocation();
+	const FVector AxisOffset = FVector::UpVector * FMath::Max(CapsuleHalfHeight - CapsuleRadius, 0.f);
+	FVector ClosestOnPath;
+	FVector ClosestOnCapsule;
+	FMath::SegmentDistToSegmentSafe(From, To, PlayerLocation - AxisOffset, PlayerLocation + AxisOffset, ClosestOnPath, ClosestOnCapsule);
+
+	if (FVector::DistSquared(ClosestOnPath, ClosestOnCapsule) <= FMath::Square(HitRadius + CapsuleRadius))
 	{
 		AMyProjectTest2Character* PlayerCharacter = Cast<AMyProjectTest2Character>(Player);
 		if (!PlayerCharacter)
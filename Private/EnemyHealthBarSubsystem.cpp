@@ -0,0 +1,159 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "EnemyHealthBarSubsystem.h"
+#include "AI_Character.h"
+#include "CombatFrameSubsystem.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "SceneView.h"
+#include "Widgets/SInvalidationPanel.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Health Bars"), STAT_EnemyHealthBars, STATGROUP_Game);
+
+namespace EnemyHealthBars
+{
+	static const FVector BarOffset(0.f, 0.f, 200.f); // Above the capsule center
+
+	// Bars shrink from full size up close to half size far away
+	static constexpr float NearDistance = 200.f;
+	static constexpr float FarDistance = 2000.f;
+	static constexpr float NearScale = 1.f;
+	static constexpr float FarScale = 0.5f;
+}
+
+UEnemyHealthBarSubsystem* UEnemyHealthBarSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UEnemyHealthBarSubsystem>() : nullptr;
+}
+
+bool UEnemyHealthBarSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UEnemyHealthBarSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (UCombatFrameSubsystem* CombatFrame = UCombatFrameSubsystem::Get(this))
+	{
+		CombatFrame->AddStageWork(ECombatFrameStage::Presentation, this,
+			[this](const FCombatSnapshot& Snapshot, float) { UpdateBars(Snapshot); });
+	}
+}
+
+void UEnemyHealthBarSubsystem::Deinitialize()
+{
+	if (UCombatFrameSubsystem* CombatFrame = UCombatFrameSubsystem::Get(this))
+	{
+		CombatFrame->RemoveStageWork(this);
+	}
+
+	if (LayerRoot.IsValid())
+	{
+		if (UGameViewportClient* Viewport = GetWorld()->GetGameViewport())
+		{
+			Viewport->RemoveViewportWidgetContent(LayerRoot.ToSharedRef());
+		}
+	}
+	LayerRoot.Reset();
+	Layer.Reset();
+	Draining.Empty();
+
+	Super::Deinitialize();
+}
+
+void UEnemyHealthBarSubsystem::AddDrain(AAI_Character* Grunt)
+{
+	Draining.AddUnique(Grunt);
+}
+
+void UEnemyHealthBarSubsystem::UpdateDrains()
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	for (int32 Index = Draining.Num() - 1; Index >= 0; --Index)
+	{
+		AAI_Character* Grunt = Draining[Index].Get();
+		if (!Grunt || !Grunt->UpdateHealthLerp(Now))
+		{
+			Draining.RemoveAtSwap(Index);
+		}
+	}
+}
+
+bool UEnemyHealthBarSubsystem::EnsureLayer()
+{
+	if (Layer.IsValid())
+	{
+		return true;
+	}
+
+	UGameViewportClient* Viewport = GetWorld()->GetGameViewport();
+	if (!Viewport)
+	{
+		return false;
+	}
+
+	// The invalidation panel caches the layer's draw between the frames where no bar changed
+	LayerRoot = SNew(SInvalidationPanel)
+		[
+			SAssignNew(Layer, SEnemyHealthBars)
+		];
+	Viewport->AddViewportWidgetContent(LayerRoot.ToSharedRef(), -1);
+	return true;
+}
+
+void UEnemyHealthBarSubsystem::UpdateBars(const FCombatSnapshot& Snapshot)
+{
+	SCOPE_CYCLE_COUNTER(STAT_EnemyHealthBars);
+
+	UpdateDrains();
+
+	if (!EnsureLayer())
+	{
+		return;
+	}
+
+	FrameBars.Reset();
+
+	// One view-projection matrix for every bar rather than rebuilding it per projection
+	const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	const ULocalPlayer* LocalPlayer = PlayerController ? PlayerController->GetLocalPlayer() : nullptr;
+	FSceneViewProjectionData ProjectionData;
+	if (LocalPlayer && LocalPlayer->ViewportClient
+		&& LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, ProjectionData))
+	{
+		const FMatrix ViewProjection = ProjectionData.ComputeViewProjectionMatrix();
+		const FIntRect ViewRect = ProjectionData.GetConstrainedViewRect();
+
+		const UCombatFrameSubsystem* CombatFrame = UCombatFrameSubsystem::Get(this);
+		for (const TWeakObjectPtr<ACharacter>& Enemy : CombatFrame->GetEnemies())
+		{
+			const AAI_Character* Grunt = Cast<AAI_Character>(Enemy.Get());
+			if (!Grunt || !Grunt->ShouldShowHealthBar())
+			{
+				continue;
+			}
+
+			const FVector BarLocation = Grunt->GetActorLocation() + EnemyHealthBars::BarOffset;
+			FVector2D ScreenPosition;
+			if (!FSceneView::ProjectWorldToScreen(BarLocation, ViewRect, ViewProjection, ScreenPosition))
+			{
+				continue;
+			}
+
+			FEnemyHealthBar& Bar = FrameBars.AddDefaulted_GetRef();
+			Bar.Position = ScreenPosition;
+			Bar.Fraction = Grunt->GetHealthBarFraction();
+			Bar.Scale = FMath::GetMappedRangeValueClamped(
+				FVector2D(EnemyHealthBars::NearDistance, EnemyHealthBars::FarDistance),
+				FVector2D(EnemyHealthBars::NearScale, EnemyHealthBars::FarScale),
+				FVector::Dist(Grunt->GetActorLocation(), Snapshot.PlayerLocation));
+		}
+	}
+
+	Layer->SetBars(FrameBars);
+}
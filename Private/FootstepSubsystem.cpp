@@ -0,0 +1,228 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FootstepSubsystem.h"
+#include "CombatAudioSubsystem.h"
+#include "CombatFrameSubsystem.h"
+#include "Components/AudioComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+DECLARE_CYCLE_STAT(TEXT("Footsteps"), STAT_Footsteps, STATGROUP_Game);
+
+static TAutoConsoleVariable<float> CVarFootstepsCrowdDistance(
+	TEXT("Combat.Footsteps.CrowdDistance"),
+	1500.f,
+	TEXT("Crowd members further than this from the listener feed the crowd loop instead of playing their own footsteps."));
+
+static TAutoConsoleVariable<float> CVarFootstepsCrowdFullRate(
+	TEXT("Combat.Footsteps.CrowdFullRate"),
+	12.f,
+	TEXT("Far away steps per second at which the crowd loop reaches full volume."));
+
+UFootstepSubsystem* UFootstepSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UFootstepSubsystem>() : nullptr;
+}
+
+bool UFootstepSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UFootstepSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (UCombatFrameSubsystem* CombatFrame = UCombatFrameSubsystem::Get(this))
+	{
+		CombatFrame->AddStageWork(ECombatFrameStage::Presentation, this,
+			[this](const FCombatSnapshot&, float DeltaTime) { UpdateFootsteps(DeltaTime); });
+	}
+}
+
+void UFootstepSubsystem::Deinitialize()
+{
+	if (UCombatFrameSubsystem* CombatFrame = UCombatFrameSubsystem::Get(this))
+	{
+		CombatFrame->RemoveStageWork(this);
+	}
+
+	if (CrowdLoop)
+	{
+		CrowdLoop->Stop();
+		CrowdLoop = nullptr;
+	}
+	Walkers.Empty();
+
+	Super::Deinitialize();
+}
+
+void UFootstepSubsystem::Register(ACharacter* Character, FFootstepSettings Settings)
+{
+	if (!IsValid(Character))
+	{
+		return;
+	}
+
+	FWalker* Walker = Walkers.FindByPredicate([Character](const FWalker& Existing) { return Existing.Character == Character; });
+	if (!Walker)
+	{
+		Walker = &Walkers.AddDefaulted_GetRef();
+		Walker->Character = Character;
+	}
+
+	Walker->Settings = MoveTemp(Settings);
+	Walker->LastLocation = Character->GetActorLocation();
+	Walker->Distance = 0.f;
+}
+
+void UFootstepSubsystem::Unregister(const ACharacter* Character)
+{
+	Walkers.RemoveAllSwap([Character](const FWalker& Walker) { return Walker.Character == Character; });
+}
+
+void UFootstepSubsystem::SetCrowdLoop(USoundBase* Sound)
+{
+	if (!CrowdLoopSound)
+	{
+		CrowdLoopSound = Sound;
+	}
+}
+
+void UFootstepSubsystem::UpdateFootsteps(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_Footsteps);
+
+	FVector ListenerLocation = FVector::ZeroVector;
+	bool bHasListener = false;
+	if (const APlayerController* PlayerController = UGameplayStatics::GetPlayerController(this, 0))
+	{
+		FVector FrontDir;
+		FVector RightDir;
+		PlayerController->GetAudioListenerPosition(ListenerLocation, FrontDir, RightDir);
+		bHasListener = true;
+	}
+	const float CrowdDistanceSquared = FMath::Square(CVarFootstepsCrowdDistance.GetValueOnGameThread());
+
+	int32 CrowdSteps = 0;
+	FVector CrowdSum = FVector::ZeroVector;
+	for (int32 Index = Walkers.Num() - 1; Index >= 0; --Index)
+	{
+		FWalker& Walker = Walkers[Index];
+		ACharacter* Character = Walker.Character.Get();
+		if (!Character)
+		{
+			Walkers.RemoveAtSwap(Index);
+			continue;
+		}
+
+		const FVector Location = Character->GetActorLocation();
+		const FVector Moved = Location - Walker.LastLocation;
+		Walker.LastLocation = Location;
+
+		const UCharacterMovementComponent* Movement = Character->GetCharacterMovement();
+		if (!Movement || !Movement->IsMovingOnGround() || (Walker.Settings.CanStep && !Walker.Settings.CanStep()))
+		{
+			// Start the next walk on a fresh stride
+			Walker.Distance = 0.f;
+			continue;
+		}
+
+		Walker.Distance += Moved.Size2D();
+		if (Walker.Distance < Walker.Settings.StrideLength)
+		{
+			continue;
+		}
+
+		// One step per frame at most; a teleport shouldn't fire a burst of them
+		Walker.Distance = FMath::Fmod(Walker.Distance, FMath::Max(Walker.Settings.StrideLength, 1.f));
+
+		FFootstepEvent Event;
+		Event.Character = Character;
+		Event.Location = Movement->CurrentFloor.HitResult.ImpactPoint;
+		Event.Surface = GetFloorSurface(Movement->CurrentFloor.HitResult);
+		Event.bInCrowd = Walker.Settings.bCanJoinCrowd && bHasListener
+			&& FVector::DistSquared(Location, ListenerLocation) > CrowdDistanceSquared;
+
+		if (Event.bInCrowd)
+		{
+			++CrowdSteps;
+			CrowdSum += Location;
+		}
+		else
+		{
+			UCombatAudioSubsystem::PlayCue(Character, Walker.Settings.Sound, Event.Location, ECombatAudioCategory::Footstep, Walker.Settings.Volume);
+		}
+
+		if (Walker.Settings.NoiseLoudness > 0.f)
+		{
+			Character->MakeNoise(Walker.Settings.NoiseLoudness, Character, Event.Location);
+		}
+
+		OnFootstep.Broadcast(Event);
+	}
+
+	UpdateCrowdLoop(DeltaTime, CrowdSteps, CrowdSteps > 0 ? CrowdSum / CrowdSteps : CrowdLocation);
+}
+
+EPhysicalSurface UFootstepSubsystem::GetFloorSurface(const FHitResult& FloorHit)
+{
+	// Floor sweeps don't return a physical material unless asked, so fall back to the floor body's own
+	const UPhysicalMaterial* PhysMaterial = FloorHit.PhysMaterial.Get();
+	if (!PhysMaterial)
+	{
+		if (const UPrimitiveComponent* Floor = FloorHit.GetComponent())
+		{
+			PhysMaterial = Floor->BodyInstance.GetSimplePhysicalMaterial();
+		}
+	}
+	return UPhysicalMaterial::DetermineSurfaceType(PhysMaterial);
+}
+
+void UFootstepSubsystem::UpdateCrowdLoop(float DeltaTime, int32 CrowdSteps, const FVector& CrowdCenter)
+{
+	if (!CrowdLoopSound || DeltaTime <= 0.f)
+	{
+		return;
+	}
+
+	// Smooth over about half a second so the layer swells and fades instead of pulsing with individual steps
+	const float Blend = 1.f - FMath::Exp(-DeltaTime / 0.5f);
+	CrowdStepRate = FMath::Lerp(CrowdStepRate, CrowdSteps / DeltaTime, Blend);
+	const bool bWasSilent = !CrowdLoop || !CrowdLoop->IsPlaying();
+	CrowdLocation = bWasSilent ? CrowdCenter : FMath::Lerp(CrowdLocation, CrowdCenter, CrowdSteps > 0 ? Blend : 0.f);
+
+	const float Volume = FMath::Clamp(CrowdStepRate / FMath::Max(CVarFootstepsCrowdFullRate.GetValueOnGameThread(), 1.f), 0.f, 1.f);
+	if (Volume < 0.01f)
+	{
+		if (CrowdLoop && CrowdLoop->IsPlaying())
+		{
+			CrowdLoop->Stop();
+		}
+		return;
+	}
+
+	if (!CrowdLoop)
+	{
+		CrowdLoop = UGameplayStatics::SpawnSoundAtLocation(this, CrowdLoopSound, CrowdLocation, FRotator::ZeroRotator,
+			Volume, 1.f, 0.f, nullptr, nullptr, false);
+		if (!CrowdLoop)
+		{
+			return;
+		}
+	}
+	else if (!CrowdLoop->IsPlaying())
+	{
+		CrowdLoop->Play();
+	}
+
+	CrowdLoop->SetWorldLocation(CrowdLocation);
+	CrowdLoop->SetVolumeMultiplier(Volume);
+}
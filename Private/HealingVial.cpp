@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HealingVial.h"
+#include "CombatLightSubsystem.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "TimerManager.h"
+
+AHealingVial::AHealingVial()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	VialMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("VialMesh"));
+	RootComponent = VialMesh;
+
+	// Bouncy physics body that reports hits and doesn't tunnel through thin floors
+	VialMesh->SetCollisionProfileName(TEXT("PhysicsActor"));
+	VialMesh->SetCollisionObjectType(ECC_PhysicsBody);
+	VialMesh->SetNotifyRigidBodyCollision(true);
+	VialMesh->SetEnableGravity(true);
+	VialMesh->BodyInstance.bUseCCD = true;
+	VialMesh->BodyInstance.LinearDamping = 0.1f;
+	VialMesh->BodyInstance.AngularDamping = 0.1f;
+	VialMesh->BodyInstance.SetMaxAngularVelocityInRadians(FMath::DegreesToRadians(1000.0f), false);
+}
+
+void AHealingVial::Throw(UStaticMesh* Mesh, const FTransform& Transform, const FVector& Impulse, const FVector& Torque)
+{
+	bInUse = true;
+	if (VialMesh->GetStaticMesh() != Mesh)
+	{
+		VialMesh->SetStaticMesh(Mesh);
+	}
+
+	SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	VialMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+	VialMesh->SetSimulatePhysics(true);
+	VialMesh->SetPhysicsLinearVelocity(FVector::ZeroVector);
+	VialMesh->SetPhysicsAngularVelocityInDegrees(FVector::ZeroVector);
+	VialMesh->AddImpulse(Impulse, NAME_None, true);
+	VialMesh->AddTorqueInRadians(Torque, NAME_None, true);
+
+	GetWorldTimerManager().SetTimer(LifetimeTimerHandle, this, &AHealingVial::ReturnToPool, Lifetime, false);
+}
+
+void AHealingVial::Shatter(const FVector& Location)
+{
+	FCombatLightRequest Flash;
+	Flash.Location = Location;
+	Flash.Color = FLinearColor(FColor(106, 0, 2));
+	Flash.Intensity = 1000.0f;
+	Flash.AttenuationRadius = 150.0f;
+	Flash.Duration = ImpactFlashDuration * 0.5f;
+	Flash.FadeOut = ImpactFlashDuration * 0.5f;
+	UCombatLightSubsystem::RequestLight(this, Flash);
+
+	ReturnToPool();
+}
+
+void AHealingVial::ReturnToPool()
+{
+	GetWorldTimerManager().ClearTimer(LifetimeTimerHandle);
+
+	VialMesh->SetSimulatePhysics(false);
+	VialMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	SetActorHiddenInGame(true);
+	bInUse = false;
+}
@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PlayerActivityComponent.h"
+#include "CombatFrameSubsystem.h"
+#include "MyProjectTest2/CPP_Repo/MyProjectTest2Character.h"
+
+UPlayerActivityComponent::UPlayerActivityComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+void UPlayerActivityComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	Character = Cast<AMyProjectTest2Character>(GetOwner());
+
+	// Let every component look at the starting state once, then go idle if there is nothing to do
+	Wake();
+}
+
+void UPlayerActivityComponent::Wake()
+{
+	if (Character && !IsComponentTickEnabled())
+	{
+		SetComponentTickEnabled(true);
+	}
+}
+
+void UPlayerActivityComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (Character)
+	{
+		if (const UCombatFrameSubsystem* CombatFrame = UCombatFrameSubsystem::Get(this))
+		{
+			const float FixedStep = CombatFrame->GetFixedStep();
+			for (int32 Step = 0; Step < CombatFrame->GetSimStepsThisFrame(); ++Step)
+			{
+				TickSimulation(FixedStep);
+			}
+		}
+		else
+		{
+			TickSimulation(DeltaTime);
+		}
+		TickActivity(DeltaTime);
+	}
+
+	if (!Character || !HasWork())
+	{
+		SetComponentTickEnabled(false);
+	}
+}
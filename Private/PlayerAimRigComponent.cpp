@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PlayerAimRigComponent.h"
+#include "Camera/CameraComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "MyProjectTest2/CPP_Repo/MyProjectTest2Character.h"
+
+// How far the camera or neck may drift (cm) before the look-at has to be redone
+static constexpr float ViewSettleTolerance = 0.5f;
+
+void UPlayerAimRigComponent::TickSimulation(float FixedStep)
+{
+	// Bow draw advances with simulated time, so it takes as long at any sim rate
+	if (Character->bIsAiming && !Character->bIsInDamageState)
+	{
+		Character->AimTime += Character->AimDrawRate * FixedStep;
+	}
+}
+
+void UPlayerAimRigComponent::TickActivity(float DeltaTime)
+{
+	bViewSettled = false;
+
+	// Don't process aiming while in damage state
+	if (Character->bIsInDamageState)
+	{
+		return;
+	}
+
+	if (Character->bIsAiming)
+	{
+		Character->AimBow();
+		return;
+	}
+
+	Character->StopAiming();
+	LookAtNeck();
+}
+
+bool UPlayerAimRigComponent::HasWork() const
+{
+	return Character->bIsAiming
+		|| Character->bIsInDamageState
+		|| Character->CachedSpeed > 0.f
+		|| !bViewSettled;
+}
+
+void UPlayerAimRigComponent::LookAtNeck()
+{
+	UCameraComponent* FollowCamera = Character->GetFollowCamera();
+
+	// Get the neck socket world location
+	FVector NeckSocketLocation = Character->GetMesh()->GetSocketLocation("NeckSocket");
+	FVector CameraLocation = FollowCamera->GetComponentLocation();
+
+	// Calculate direction to the neck socket (from the camera)
+	FVector DirectionToNeck = NeckSocketLocation - CameraLocation;
+	DirectionToNeck.Normalize();
+
+	// Calculate the rotation to face the neck socket
+	FRotator TargetRotation = DirectionToNeck.Rotation();
+	FollowCamera->SetWorldRotation(TargetRotation);
+
+	bViewSettled = CameraLocation.Equals(LastCameraLocation, ViewSettleTolerance)
+		&& NeckSocketLocation.Equals(LastNeckLocation, ViewSettleTolerance);
+	LastCameraLocation = CameraLocation;
+	LastNeckLocation = NeckSocketLocation;
+}
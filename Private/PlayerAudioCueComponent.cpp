@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PlayerAudioCueComponent.h"
+#include "Components/AudioComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "MyProjectTest2/CPP_Repo/MyProjectTest2Character.h"
+
+namespace PlayerAudioCue
+{
+	// Fraction of max health below which the heartbeat plays
+	static constexpr float HeartbeatThreshold = 0.8f;
+	// Smallest change in display health fraction worth re-pushing to the loop
+	static constexpr float HeartbeatUpdateStep = 0.01f;
+}
+
+void UPlayerAudioCueComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (HeartbeatLoop)
+	{
+		HeartbeatLoop->Stop();
+		HeartbeatLoop = nullptr;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UPlayerAudioCueComponent::TickActivity(float DeltaTime)
+{
+	UpdateHeartbeat();
+}
+
+bool UPlayerAudioCueComponent::HasWork() const
+{
+	// Nothing to do until the displayed health moves far enough to change the loop
+	const float HealthFraction = GetHealthFraction();
+	const bool bWantsHeartbeat = HealthFraction <= PlayerAudioCue::HeartbeatThreshold;
+	return bWantsHeartbeat != bHeartbeatPlaying
+		|| (bWantsHeartbeat && FMath::Abs(HealthFraction - AppliedHealthFraction) >= PlayerAudioCue::HeartbeatUpdateStep);
+}
+
+float UPlayerAudioCueComponent::GetHealthFraction() const
+{
+	return Character->MaxHealth > 0.f ? Character->CurrentDisplayHealth / Character->MaxHealth : 1.f;
+}
+
+void UPlayerAudioCueComponent::UpdateHeartbeat()
+{
+	const float HealthFraction = GetHealthFraction();
+
+	if (HealthFraction > PlayerAudioCue::HeartbeatThreshold)
+	{
+		if (bHeartbeatPlaying && HeartbeatLoop)
+		{
+			HeartbeatLoop->FadeOut(0.5f, 0.f);
+		}
+		bHeartbeatPlaying = false;
+		return;
+	}
+
+	if (FMath::Abs(HealthFraction - AppliedHealthFraction) < PlayerAudioCue::HeartbeatUpdateStep && bHeartbeatPlaying)
+	{
+		return;
+	}
+
+	if (!HeartbeatLoop)
+	{
+		if (!Character->HeartSound)
+		{
+			return;
+		}
+
+		// One looping voice for the whole low-health stretch; its rate and volume follow the display health
+		HeartbeatLoop = UGameplayStatics::SpawnSoundAttached(
+			Character->HeartSound,
+			Character->GetRootComponent(),
+			NAME_None,
+			FVector::ZeroVector,
+			EAttachLocation::KeepRelativeOffset,
+			false,          // Stop when attached to destroyed
+			1.0f,           // Volume multiplier
+			1.0f,           // Pitch multiplier
+			0.0f,           // Start time
+			nullptr,        // Attenuation settings
+			nullptr,        // Concurrency settings
+			false           // Auto destroy
+		);
+		if (!HeartbeatLoop)
+		{
+			return;
+		}
+		HeartbeatLoop->Stop();
+	}
+
+	// Louder and faster the lower the health gets
+	const float Severity = 1.f - HealthFraction / PlayerAudioCue::HeartbeatThreshold;
+	HeartbeatLoop->SetVolumeMultiplier(FMath::Lerp(2.0f, 0.5f, HealthFraction));
+	HeartbeatLoop->SetPitchMultiplier(FMath::Lerp(1.0f, 1.5f, Severity));
+	HeartbeatLoop->SetFloatParameter(HeartRateParameter, Severity);
+
+	if (!bHeartbeatPlaying)
+	{
+		HeartbeatLoop->FadeIn(0.5f);
+		bHeartbeatPlaying = true;
+	}
+	AppliedHealthFraction = HealthFraction;
+}
@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PlayerDodgeComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "MyProjectTest2/CPP_Repo/MyProjectTest2Character.h"
+
+void UPlayerDodgeComponent::TickActivity(float DeltaTime)
+{
+	// Don't process movement if in damage state
+	if (Character->bIsInDamageState)
+	{
+		return;
+	}
+
+	if (Character->IsAttacking)
+	{
+		UpdateAttackLunge(DeltaTime);
+	}
+
+	// If the character is rolling, advance the roll
+	if (Character->IsRolling)
+	{
+		UpdateRoll(DeltaTime);
+	}
+}
+
+bool UPlayerDodgeComponent::HasWork() const
+{
+	return Character->IsAttacking || Character->IsRolling;
+}
+
+void UPlayerDodgeComponent::UpdateAttackLunge(float DeltaTime)
+{
+	if (Character->AttackTimeCounter < Character->AttackDuration * 0.3f)
+	{
+		FVector AttackDirection = Character->GetActorForwardVector();
+		AttackDirection.Normalize();
+		FVector AttackMovement = AttackDirection * 100.f * DeltaTime;
+		Character->GetCharacterMovement()->MoveUpdatedComponent(AttackMovement, Character->GetActorRotation(), true);
+	}
+
+
+	Character->AttackTimeCounter += DeltaTime;
+	if (Character->AttackTimeCounter >= Character->AttackDuration)
+	{
+		Character->StopAttack();
+		Character->AttackFinished = true;
+	}
+}
+
+void UPlayerDodgeComponent::UpdateRoll(float DeltaTime)
+{
+	Character->RollDuration += DeltaTime;
+
+	// Ensure movement direction is valid, defaulting to forward if no input
+	FVector RollDirection = Character->MoveDirection.IsNearlyZero() ? Character->GetActorForwardVector() : Character->MoveDirection;
+
+	// Normalize before modifying it
+	RollDirection.Normalize();
+
+	// Define roll speed and lift (adjust as needed)
+	RollDirection = RollDirection * 1100.f + FVector(0.f, 0.f, 200.f);
+
+	// Normalize again to maintain consistent speed
+	RollDirection.Normalize();
+
+	// Calculate roll movement
+	FVector RollMovement = RollDirection * Character->GetCharacterMovement()->MaxWalkSpeed * DeltaTime;
+
+	// Apply movement
+	Character->GetCharacterMovement()->MoveUpdatedComponent(RollMovement, Character->GetActorRotation(), true);
+
+	// Stop rolling after reaching duration
+	if (Character->RollDuration >= Character->MaxRollDuration)
+	{
+		Character->IsRolling = false;
+		Character->StopRolling();
+		Character->RollFinished = true;
+	}
+}
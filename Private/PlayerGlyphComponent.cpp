@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PlayerGlyphComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/World.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "Materials/MaterialParameterCollectionInstance.h"
+#include "MyProjectTest2/CPP_Repo/MyProjectTest2Character.h"
+
+void UPlayerGlyphComponent::Show()
+{
+    Character->bIsHealingGlyphActive = true;
+    Character->bIsHealingGlyphFading = false;
+    Character->HealingGlyphTimer = 0.0f;
+    ApplyFade(1.0f);
+    Wake();
+}
+
+void UPlayerGlyphComponent::TickActivity(float DeltaTime)
+{
+    if (!Character->bIsHealingGlyphActive)
+        return;
+
+    UStaticMeshComponent* HealingGlyphMesh = Character->HealingGlyphMesh;
+
+    // Rotate the glyph
+    if (HealingGlyphMesh)
+    {
+        FRotator NewRotation = HealingGlyphMesh->GetComponentRotation();
+        NewRotation.Yaw += Character->GlyphRotationSpeed * DeltaTime;
+        HealingGlyphMesh->SetWorldRotation(NewRotation);
+    }
+
+    // Handle the intensity of both the glyph and light
+    Character->HealingGlyphTimer += DeltaTime;
+
+    if (!Character->bIsHealingGlyphFading && Character->HealingGlyphTimer >= Character->HealingGlyphDuration)
+    {
+        Character->bIsHealingGlyphFading = true;
+        Character->HealingGlyphTimer = 0.0f;
+    }
+
+    if (Character->bIsHealingGlyphFading)
+    {
+        // Calculate fade factor (1.0 to 0.0)
+        float FadeFactor = 1.0f - FMath::Clamp(Character->HealingGlyphTimer / Character->HealingGlyphFadeOutDuration, 0.0f, 1.0f);
+        ApplyFade(FadeFactor);
+
+        // Deactivate everything when fully faded
+        if (Character->HealingGlyphTimer >= Character->HealingGlyphFadeOutDuration)
+        {
+            Character->DeactivateHealingGlyph();
+        }
+    }
+}
+
+bool UPlayerGlyphComponent::HasWork() const
+{
+	return Character->bIsHealingGlyphActive;
+}
+
+void UPlayerGlyphComponent::ApplyFade(float FadeFactor)
+{
+	const float Intensity = Character->HealingGlyphInitialIntensity * FadeFactor;
+
+	if (FadeParameters)
+	{
+		// The world keeps one instance per collection; look it up once rather than every frame
+		if (!FadeParametersInstance)
+		{
+			FadeParametersInstance = GetWorld()->GetParameterCollectionInstance(FadeParameters);
+		}
+		if (FadeParametersInstance)
+		{
+			FadeParametersInstance->SetScalarParameterValue(OpacityParameter, FadeFactor);
+			FadeParametersInstance->SetScalarParameterValue(IntensityParameter, Intensity);
+		}
+	}
+	else if (UStaticMeshComponent* HealingGlyphMesh = Character->HealingGlyphMesh)
+	{
+		// Made on the first heal and kept on the mesh for every heal after
+		if (!GlyphMaterial)
+		{
+			GlyphMaterial = HealingGlyphMesh->CreateAndSetMaterialInstanceDynamic(0);
+		}
+		if (GlyphMaterial)
+		{
+			GlyphMaterial->SetScalarParameterValue(OpacityParameter, FadeFactor);
+		}
+	}
+}
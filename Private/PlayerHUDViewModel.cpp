@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PlayerHUDViewModel.h"
+
+namespace PlayerHUD
+{
+	// Smallest changes worth a HUD update: a fraction of a bar pixel for health and stamina, 1% for restock rings
+	static constexpr float HealthStep = 0.25f;
+	static constexpr float StaminaStep = 1.f;
+	static constexpr float ProgressStep = 0.01f;
+}
+
+void UPlayerHUDViewModel::SetHealth(float Value, float MaxValue)
+{
+	SetPair(Health, MaxHealth, Value, MaxValue, PlayerHUD::HealthStep, EPlayerHUDField::Health);
+}
+
+void UPlayerHUDViewModel::SetDisplayHealth(float Value)
+{
+	// Snap onto the target so the eased bar always lands exactly, however small the last step
+	if (FMath::Abs(Value - DisplayHealth) >= PlayerHUD::HealthStep || (Value == Health && DisplayHealth != Health))
+	{
+		DisplayHealth = Value;
+		OnFieldChanged.Broadcast(EPlayerHUDField::DisplayHealth);
+	}
+}
+
+void UPlayerHUDViewModel::SetStamina(float Value, float MaxValue)
+{
+	SetPair(Stamina, MaxStamina, Value, MaxValue, PlayerHUD::StaminaStep, EPlayerHUDField::Stamina);
+}
+
+void UPlayerHUDViewModel::SetArrows(int32 Value, int32 MaxValue)
+{
+	SetPair(Arrows, MaxArrows, Value, MaxValue, EPlayerHUDField::Arrows);
+}
+
+void UPlayerHUDViewModel::SetCrossbowArrows(int32 Value, int32 MaxValue)
+{
+	SetPair(CrossbowArrows, MaxCrossbowArrows, Value, MaxValue, EPlayerHUDField::CrossbowArrows);
+}
+
+void UPlayerHUDViewModel::SetHealthVials(int32 Value, int32 MaxValue)
+{
+	SetPair(HealthVials, MaxHealthVials, Value, MaxValue, EPlayerHUDField::HealthVials);
+}
+
+void UPlayerHUDViewModel::SetArrowRestock(float Progress)
+{
+	SetProgress(ArrowRestock, Progress, EPlayerHUDField::ArrowRestock);
+}
+
+void UPlayerHUDViewModel::SetCrossbowRestock(float Progress)
+{
+	SetProgress(CrossbowRestock, Progress, EPlayerHUDField::CrossbowRestock);
+}
+
+void UPlayerHUDViewModel::SetVialRestock(float Progress)
+{
+	SetProgress(VialRestock, Progress, EPlayerHUDField::VialRestock);
+}
+
+void UPlayerHUDViewModel::SetPair(float& Field, float& MaxField, float Value, float MaxValue, float Step, EPlayerHUDField Id)
+{
+	// Reaching empty or full always shows, even when the last change was below the step
+	const bool bHitLimit = (Value <= 0.f || Value >= MaxValue) && Value != Field;
+	if (FMath::Abs(Value - Field) >= Step || bHitLimit || MaxValue != MaxField)
+	{
+		Field = Value;
+		MaxField = MaxValue;
+		OnFieldChanged.Broadcast(Id);
+	}
+}
+
+void UPlayerHUDViewModel::SetPair(int32& Field, int32& MaxField, int32 Value, int32 MaxValue, EPlayerHUDField Id)
+{
+	if (Value != Field || MaxValue != MaxField)
+	{
+		Field = Value;
+		MaxField = MaxValue;
+		OnFieldChanged.Broadcast(Id);
+	}
+}
+
+void UPlayerHUDViewModel::SetProgress(float& Field, float Progress, EPlayerHUDField Id)
+{
+	Progress = FMath::Clamp(Progress, 0.f, 1.f);
+	if (FMath::Abs(Progress - Field) >= PlayerHUD::ProgressStep || (Progress == 0.f && Field != 0.f))
+	{
+		Field = Progress;
+		OnFieldChanged.Broadcast(Id);
+	}
+}
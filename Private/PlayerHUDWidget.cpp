@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PlayerHUDWidget.h"
+#include "MyProjectTest2/CPP_Repo/MyProjectTest2Character.h"
+
+void UPlayerHUDWidget::NativeConstruct()
+{
+	Super::NativeConstruct();
+
+	const AMyProjectTest2Character* Character = Cast<AMyProjectTest2Character>(GetOwningPlayerPawn());
+	ViewModel = Character ? Character->GetHUDViewModel() : nullptr;
+	if (!ViewModel)
+	{
+		return;
+	}
+
+	ViewModel->OnFieldChanged.AddUniqueDynamic(this, &UPlayerHUDWidget::HandleFieldChanged);
+
+	// Start from the current values; after this only changes come through
+	for (uint8 Field = 0; Field <= static_cast<uint8>(EPlayerHUDField::VialRestock); ++Field)
+	{
+		OnHUDFieldChanged(static_cast<EPlayerHUDField>(Field));
+	}
+}
+
+void UPlayerHUDWidget::NativeDestruct()
+{
+	if (ViewModel)
+	{
+		ViewModel->OnFieldChanged.RemoveDynamic(this, &UPlayerHUDWidget::HandleFieldChanged);
+		ViewModel = nullptr;
+	}
+
+	Super::NativeDestruct();
+}
+
+void UPlayerHUDWidget::HandleFieldChanged(EPlayerHUDField Field)
+{
+	OnHUDFieldChanged(Field);
+}
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PlayerInventoryComponent.h"
+#include "CombatAudioSubsystem.h"
+#include "MyProjectTest2/CPP_Repo/MyProjectTest2Character.h"
+
+void UPlayerInventoryComponent::TickActivity(float DeltaTime)
+{
+	if (Character->MaxArrows > Character->Arrows)
+	{
+		Character->LastArrowTime += DeltaTime;
+	}
+	if (Character->MaxCrossbowArrows > Character->Crossbow_arrows)
+	{
+		Character->LastCrossbowTime += DeltaTime;
+	}
+	if (Character->MaxHealVials > Character->Health_vials)
+	{
+		Character->LastVialTime += DeltaTime;
+	}
+	
+	if (Character->MaxArrows > Character->Arrows && Character->LastArrowTime > Character->LastArrowTimeGoal)
+	{
+		Character->Arrows = FMath::Clamp(Character->Arrows + 1, 0.0, Character->MaxArrows);
+		Character->LastArrowTime = 0.f;
+
+		UCombatAudioSubsystem::PlayCue(
+			Character,      // World context object
+			Character->BowRestockSound,// Sound to play
+			Character->GetActorLocation(), // Location to play sound
+			ECombatAudioCategory::Player,
+			4.5f            // Volume multiplier
+		);
+	}
+
+	// Regenerate crossbow arrows
+	if (Character->MaxCrossbowArrows > Character->Crossbow_arrows && Character->LastCrossbowTime > Character->LastCrossbowTimeGoal)
+	{
+		Character->Crossbow_arrows = FMath::Clamp(Character->Crossbow_arrows + 1, 0.0f, Character->MaxCrossbowArrows);
+		Character->LastCrossbowTime = 0.f;
+		UCombatAudioSubsystem::PlayCue(
+			Character,      // World context object
+			Character->CrossbowRestockSound,// Sound to play
+			Character->GetActorLocation(), // Location to play sound
+			ECombatAudioCategory::Player,
+			2.5f            // Volume multiplier
+		);
+	}
+
+	// Regenerate heal vials
+	if (Character->MaxHealVials > Character->Health_vials && Character->LastVialTime > Character->LastVialTimeGoal)
+	{
+		Character->Health_vials = FMath::Clamp(Character->Health_vials + 1, 0.0f, Character->MaxHealVials);
+		Character->LastVialTime = 0.f;
+		UCombatAudioSubsystem::PlayCue(
+			Character,      // World context object
+			Character->VialRestockSound,// Sound to play
+			Character->GetActorLocation(), // Location to play sound
+			ECombatAudioCategory::Player,
+			0.4f            // Volume multiplier
+		);
+	}
+}
+
+bool UPlayerInventoryComponent::HasWork() const
+{
+	return Character->MaxArrows > Character->Arrows
+		|| Character->MaxCrossbowArrows > Character->Crossbow_arrows
+		|| Character->MaxHealVials > Character->Health_vials;
+}
@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PlayerStaminaComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "MyProjectTest2/CPP_Repo/MyProjectTest2Character.h"
+
+void UPlayerStaminaComponent::TickSimulation(float FixedStep)
+{
+	if (Character->bIsStaminaRegenPaused)
+	{
+		Character->StaminaRegenPauseTimer += FixedStep;
+		if (Character->StaminaRegenPauseTimer >= Character->StaminaRegenCooldown)
+		{
+			Character->bIsStaminaRegenPaused = false;
+		}
+	}
+
+	// Stamina is frozen while stunned
+	if (Character->bIsInDamageState)
+	{
+		return;
+	}
+
+	UCharacterMovementComponent* MovementComponent = Character->GetCharacterMovement();
+
+	if (Character->Stamina <= 0 && !Character->StaminaDepletion)
+	{
+		Character->PauseStaminaRegeneration();
+		Character->Stamina = 0;
+		Character->StaminaZeroTimer = 0.0f;
+		Character->StaminaDepletion = true;
+		Character->StaminaRegenRate = Character->BaseStaminaRegenRate; // Reset regen rate when stamina is depleted
+    
+		// Reduce movement speed when stamina is depleted
+		if (!Character->IsRolling && !Character->bIsAiming) // Don't override special movement states
+		{
+			MovementComponent->MaxWalkSpeed = 125.f; // Reduced speed when stamina is drained
+		}
+	}
+	// Stamina regeneration
+	if (Character->Stamina > 0 && !Character->StaminaDepletion && !Character->bIsStaminaRegenPaused)
+	{
+		// Increase regeneration rate over time
+		Character->StaminaRegenRate = FMath::Min(Character->StaminaRegenRate + (FixedStep * Character->StaminaRegenAcceleration), Character->MaxStaminaRegenRate);
+    
+		// Apply the current regeneration rate
+		Character->Stamina += FixedStep * Character->StaminaRegenRate;
+		Character->Stamina = FMath::Clamp(Character->Stamina, 0.f, Character->MaxStamina);
+    
+		// Restore normal movement speed if it was reduced due to stamina depletion
+		if (MovementComponent->MaxWalkSpeed == 125.f && !Character->IsRolling && !Character->bIsAiming && !Character->WasSprinting && !Character->isCrouching)
+		{
+			MovementComponent->MaxWalkSpeed = 500.f; // Restore to normal speed
+		}
+	}
+	else if (Character->StaminaDepletion)
+	{
+		Character->StaminaZeroTimer += FixedStep;
+		if (Character->StaminaZeroTimer >= Character->StaminaRecoveryDelay)
+		{
+			Character->Stamina = 1.f;
+			Character->StaminaDepletion = false;
+			Character->StaminaRegenRate = Character->BaseStaminaRegenRate; // Reset to base rate when recovery begins
+        
+			// Restore normal movement speed when stamina starts regenerating
+			if (MovementComponent->MaxWalkSpeed == 125.f && !Character->IsRolling && !Character->bIsAiming && !Character->WasSprinting && !Character->isCrouching)
+			{
+				MovementComponent->MaxWalkSpeed = 500.f; // Restore to normal speed
+			}
+		}
+	}
+
+	// Sprint cost is per second of simulated time, so the drain rate depends on neither frame nor sim rate
+	if (Character->WasSprinting && !Character->IsRolling)
+	{
+		const float SprintStepCost = Character->SprintCost * FixedStep;
+		Character->Stamina -= SprintStepCost;
+		if (Character->Stamina < SprintStepCost)
+		{
+			Character->StopSprinting();
+		}
+	}
+}
+
+bool UPlayerStaminaComponent::HasWork() const
+{
+	return Character->bIsStaminaRegenPaused
+		|| Character->StaminaDepletion
+		|| Character->WasSprinting
+		|| Character->Stamina < Character->MaxStamina;
+}
@@ -0,0 +1,190 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProjectilePoolSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Projectile_Arrow_Base.h"
+
+DECLARE_STATS_GROUP(TEXT("ProjectilePool"), STATGROUP_ProjectilePool, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pool Hits"), STAT_ProjectilePoolHits, STATGROUP_ProjectilePool);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pool Misses"), STAT_ProjectilePoolMisses, STATGROUP_ProjectilePool);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Recycled"), STAT_ProjectilePoolRecycled, STATGROUP_ProjectilePool);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Live Arrows"), STAT_ProjectilePoolLive, STATGROUP_ProjectilePool);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Free Arrows"), STAT_ProjectilePoolFree, STATGROUP_ProjectilePool);
+
+static TAutoConsoleVariable<int32> CVarProjectilePoolMaxArrows(
+	TEXT("Combat.ProjectilePool.MaxArrows"),
+	96,
+	TEXT("Most arrows (in flight and stuck) alive at once. Past this the oldest stuck arrow is recycled for the next shot."));
+
+UProjectilePoolSubsystem* UProjectilePoolSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UProjectilePoolSubsystem>() : nullptr;
+}
+
+bool UProjectilePoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UProjectilePoolSubsystem::Deinitialize()
+{
+	// The actors themselves go away with the world
+	Pools.Empty();
+	LiveArrows.Empty();
+	StuckArrows.Empty();
+
+	Super::Deinitialize();
+}
+
+void UProjectilePoolSubsystem::Prewarm(TSubclassOf<AProjectile_Arrow_Base> Class, int32 Count)
+{
+	if (!Class)
+	{
+		return;
+	}
+
+	FClassPool& Pool = Pools.FindOrAdd(Class.Get());
+	for (int32 Index = Pool.Free.Num(); Index < Count; ++Index)
+	{
+		if (AProjectile_Arrow_Base* Arrow = SpawnPooled(Class, FTransform::Identity))
+		{
+			Arrow->DeactivateToPool();
+			Pool.Free.Add(Arrow);
+		}
+	}
+
+	UpdateStats();
+}
+
+AProjectile_Arrow_Base* UProjectilePoolSubsystem::Acquire(TSubclassOf<AProjectile_Arrow_Base> Class, const FTransform& Transform, AActor* Owner, APawn* Instigator)
+{
+	if (!Class)
+	{
+		return nullptr;
+	}
+
+	PruneInvalid();
+
+	AProjectile_Arrow_Base* Arrow = nullptr;
+	FClassPool& Pool = Pools.FindOrAdd(Class.Get());
+	if (Pool.Free.Num() > 0)
+	{
+		Arrow = Pool.Free.Pop().Get();
+		++Stats.Hits;
+	}
+	else if (LiveArrows.Num() >= CVarProjectilePoolMaxArrows.GetValueOnGameThread())
+	{
+		Arrow = ReclaimOldest();
+		if (Arrow && Arrow->GetClass() != Class.Get())
+		{
+			// The oldest arrow was a different kind; free its slot and spawn the right one instead
+			Arrow->Destroy();
+			Arrow = nullptr;
+		}
+		++Stats.Recycled;
+	}
+
+	if (!Arrow)
+	{
+		Arrow = SpawnPooled(Class, Transform);
+		++Stats.Misses;
+	}
+
+	if (Arrow)
+	{
+		Arrow->SetOwner(Owner);
+		Arrow->SetInstigator(Instigator);
+		Arrow->ActivateFromPool(Transform);
+		LiveArrows.Add(Arrow);
+	}
+
+	UpdateStats();
+	return Arrow;
+}
+
+void UProjectilePoolSubsystem::Release(AProjectile_Arrow_Base* Arrow)
+{
+	if (!IsValid(Arrow))
+	{
+		return;
+	}
+
+	LiveArrows.Remove(Arrow);
+	StuckArrows.Remove(Arrow);
+
+	FClassPool& Pool = Pools.FindOrAdd(Arrow->GetClass());
+	if (!Pool.Free.Contains(Arrow))
+	{
+		Arrow->DeactivateToPool();
+		Pool.Free.Add(Arrow);
+	}
+
+	UpdateStats();
+}
+
+void UProjectilePoolSubsystem::NotifyStuck(AProjectile_Arrow_Base* Arrow)
+{
+	if (IsValid(Arrow))
+	{
+		StuckArrows.AddUnique(Arrow);
+	}
+}
+
+AProjectile_Arrow_Base* UProjectilePoolSubsystem::SpawnPooled(UClass* Class, const FTransform& Transform)
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return World->SpawnActor<AProjectile_Arrow_Base>(Class, Transform, SpawnParams);
+}
+
+AProjectile_Arrow_Base* UProjectilePoolSubsystem::ReclaimOldest()
+{
+	// Stuck arrows go first; only steal one still in flight when nothing is stuck
+	TArray<TWeakObjectPtr<AProjectile_Arrow_Base>>& Source = StuckArrows.Num() > 0 ? StuckArrows : LiveArrows;
+	if (Source.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	AProjectile_Arrow_Base* Arrow = Source[0].Get();
+	LiveArrows.Remove(Arrow);
+	StuckArrows.Remove(Arrow);
+	Arrow->DeactivateToPool();
+	return Arrow;
+}
+
+void UProjectilePoolSubsystem::PruneInvalid()
+{
+	// Arrows can still be destroyed from outside (level streaming, kill volumes)
+	auto IsStale = [](const TWeakObjectPtr<AProjectile_Arrow_Base>& Arrow) { return !Arrow.IsValid(); };
+	LiveArrows.RemoveAll(IsStale);
+	StuckArrows.RemoveAll(IsStale);
+	for (TPair<TObjectKey<UClass>, FClassPool>& Pair : Pools)
+	{
+		Pair.Value.Free.RemoveAll(IsStale);
+	}
+}
+
+void UProjectilePoolSubsystem::UpdateStats()
+{
+	Stats.Live = LiveArrows.Num();
+	Stats.Free = 0;
+	for (const TPair<TObjectKey<UClass>, FClassPool>& Pair : Pools)
+	{
+		Stats.Free += Pair.Value.Free.Num();
+	}
+
+	SET_DWORD_STAT(STAT_ProjectilePoolHits, Stats.Hits);
+	SET_DWORD_STAT(STAT_ProjectilePoolMisses, Stats.Misses);
+	SET_DWORD_STAT(STAT_ProjectilePoolRecycled, Stats.Recycled);
+	SET_DWORD_STAT(STAT_ProjectilePoolLive, Stats.Live);
+	SET_DWORD_STAT(STAT_ProjectilePoolFree, Stats.Free);
+}
@@ -0,0 +1,592 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProjectileSimSubsystem.h"
+#include "Async/ParallelFor.h"
+#include "CombatAudioSubsystem.h"
+#include "CombatFrameSubsystem.h"
+#include "Engine/DamageEvents.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/App.h"
+#include "MyProjectTest2/CPP_Repo/MyProjectTest2Character.h"
+#include "Projectile_Arrow_Base.h"
+#include "ProjectilePoolSubsystem.h"
+#include "UObject/SoftObjectPath.h"
+
+DECLARE_STATS_GROUP(TEXT("ProjectileSim"), STATGROUP_ProjectileSim, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Integrate + Sweep"), STAT_ProjectileSimStep, STATGROUP_ProjectileSim);
+DECLARE_CYCLE_STAT(TEXT("Transform Sync"), STAT_ProjectileSimPresent, STATGROUP_ProjectileSim);
+DECLARE_CYCLE_STAT(TEXT("Resolve Hits"), STAT_ProjectileSimResolveHits, STATGROUP_ProjectileSim);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Arrows In Flight"), STAT_ProjectileSimInFlight, STATGROUP_ProjectileSim);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hits Resolved"), STAT_ProjectileSimHitsResolved, STATGROUP_ProjectileSim);
+
+static TAutoConsoleVariable<int32> CVarProjectileParallelSweeps(
+	TEXT("Combat.Projectiles.ParallelSweeps"),
+	1,
+	TEXT("Issue arrow sweeps from worker threads. 0 runs them serially on the game thread."));
+
+static TAutoConsoleVariable<float> CVarProjectileMaxLifetime(
+	TEXT("Combat.Projectiles.MaxLifetime"),
+	10.f,
+	TEXT("Seconds an arrow may fly without hitting anything before it goes back to the pool."));
+
+namespace ProjectileSim
+{
+	// Impacts in the same cell in one step share a sound and effect
+	static constexpr float EffectCellSize = 100.f;
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdProjectileBenchmarkVolley(
+	TEXT("Combat.Projectiles.BenchmarkVolley"),
+	TEXT("Fires arrow rain volleys from the player and logs the projectile frame cost. Args: [ArrowsPerVolley=500] [Volleys=5] [IntervalFrames=30] [ArrowClassPath=the player's bow arrow]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UProjectileSimSubsystem* ProjectileSim = UProjectileSimSubsystem::Get(World);
+		if (!ProjectileSim)
+		{
+			return;
+		}
+
+		const int32 ArrowsPerVolley = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 500;
+		const int32 Volleys = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 5;
+		const int32 Interval = Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 30;
+
+		// Fire what the bow fires, with its mesh, trail, hit effect and damage, so the cost matches a real volley
+		const AMyProjectTest2Character* Player = Cast<AMyProjectTest2Character>(UGameplayStatics::GetPlayerPawn(World, 0));
+		TSubclassOf<AProjectile_Arrow_Base> Class = Player ? Player->GetProjectileClass() : nullptr;
+		if (Args.Num() > 3)
+		{
+			Class = FSoftClassPath(Args[3]).TryLoadClass<AProjectile_Arrow_Base>();
+		}
+		if (!Class)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Volley benchmark: no arrow class; give a class path or possess the player character"));
+			return;
+		}
+
+		const float Damage = Player ? Player->GetBowArrowDamage() : Class->GetDefaultObject<AProjectile_Arrow_Base>()->GetDamage();
+		ProjectileSim->StartVolleyBenchmark(Class, ArrowsPerVolley, Volleys, Interval, Damage);
+	}));
+
+UProjectileSimSubsystem* UProjectileSimSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UProjectileSimSubsystem>() : nullptr;
+}
+
+bool UProjectileSimSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UProjectileSimSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	if (UCombatFrameSubsystem* CombatFrame = UCombatFrameSubsystem::Get(this))
+	{
+		// Sweeps fan out to workers and only record hits; everything that touches arrows or targets happens in ResolveHits
+		CombatFrame->AddStageWork(ECombatFrameStage::ProjectileSim, this,
+			[this](const FCombatSnapshot&, float FixedStep) { Step(FixedStep); });
+		CombatFrame->AddStageWork(ECombatFrameStage::DamageResolution, this,
+			[this](const FCombatSnapshot&, float) { ResolveHits(); });
+		CombatFrame->AddStageWork(ECombatFrameStage::Presentation, this,
+			[this](const FCombatSnapshot& Snapshot, float) { Present(Snapshot.InterpolationAlpha); });
+	}
+}
+
+void UProjectileSimSubsystem::Deinitialize()
+{
+	if (UCombatFrameSubsystem* CombatFrame = UCombatFrameSubsystem::Get(this))
+	{
+		CombatFrame->RemoveStageWork(this);
+	}
+
+	if (Benchmark.bActive)
+	{
+		EndVolleyBenchmark();
+	}
+
+	Arrows.Empty();
+	Positions.Empty();
+	PreviousPositions.Empty();
+	Velocities.Empty();
+	Gravity.Empty();
+	Ages.Empty();
+	Radii.Empty();
+	Queries.Empty();
+	PendingHits.Empty();
+	ResolveBatch.Empty();
+	ExpiredArrows.Empty();
+
+	Super::Deinitialize();
+}
+
+void UProjectileSimSubsystem::Launch(AProjectile_Arrow_Base* Arrow, const FVector& Velocity, float GravityScale, float SweepRadius)
+{
+	if (!IsValid(Arrow))
+	{
+		return;
+	}
+
+	int32 Index = Arrows.IndexOfByKey(Arrow);
+	if (Index == INDEX_NONE)
+	{
+		Index = AddSlot(Arrow);
+	}
+
+	InitFlight(Index, Arrow, Velocity, GravityScale, SweepRadius);
+	SET_DWORD_STAT(STAT_ProjectileSimInFlight, Arrows.Num());
+}
+
+int32 UProjectileSimSubsystem::FireVolley(TSubclassOf<AProjectile_Arrow_Base> Class, const FVector& Origin, TConstArrayView<FVector> Directions,
+	float Speed, float Damage, APawn* Instigator, USoundBase* ReleaseSound)
+{
+	UProjectilePoolSubsystem* Pool = UProjectilePoolSubsystem::Get(this);
+	if (!Pool || !Class || Directions.Num() == 0)
+	{
+		return 0;
+	}
+
+	const int32 Reserve = Arrows.Num() + Directions.Num();
+	Arrows.Reserve(Reserve);
+	Positions.Reserve(Reserve);
+	PreviousPositions.Reserve(Reserve);
+	Velocities.Reserve(Reserve);
+	Gravity.Reserve(Reserve);
+	Ages.Reserve(Reserve);
+	Radii.Reserve(Reserve);
+	Queries.Reserve(Reserve);
+
+	int32 Fired = 0;
+	for (const FVector& Direction : Directions)
+	{
+		const FVector Velocity = Direction.GetSafeNormal() * Speed;
+		AProjectile_Arrow_Base* Arrow = Pool->Acquire(Class, FTransform(Velocity.Rotation(), Origin), Instigator, Instigator);
+		if (!Arrow)
+		{
+			continue;
+		}
+
+		Arrow->SetDamage(Damage);
+		Arrow->PrepareFlight(Velocity);
+
+		// Arrows from the pool are never in flight, so skip Launch's lookup
+		InitFlight(AddSlot(Arrow), Arrow, Velocity, Arrow->GetGravityScale(), Arrow->GetSweepRadius());
+		++Fired;
+	}
+
+	if (Fired > 0 && ReleaseSound)
+	{
+		UCombatAudioSubsystem::PlayCue(this, ReleaseSound, Origin, ECombatAudioCategory::Weapon);
+	}
+
+	SET_DWORD_STAT(STAT_ProjectileSimInFlight, Arrows.Num());
+	return Fired;
+}
+
+int32 UProjectileSimSubsystem::AddSlot(AProjectile_Arrow_Base* Arrow)
+{
+	const int32 Index = Arrows.Add(Arrow);
+	Positions.AddUninitialized();
+	PreviousPositions.AddUninitialized();
+	Velocities.AddUninitialized();
+	Gravity.AddUninitialized();
+	Ages.AddUninitialized();
+	Radii.AddUninitialized();
+	Queries.AddDefaulted();
+	return Index;
+}
+
+void UProjectileSimSubsystem::InitFlight(int32 Index, AProjectile_Arrow_Base* Arrow, const FVector& Velocity, float GravityScale, float SweepRadius)
+{
+	const UWorld* World = GetWorld();
+	const UPrimitiveComponent* Collision = Arrow->GetArrowMesh();
+
+	Positions[Index] = Arrow->GetActorLocation();
+	PreviousPositions[Index] = Positions[Index];
+	Velocities[Index] = Velocity;
+	Gravity[Index] = (World ? World->GetGravityZ() : 0.f) * GravityScale;
+	Ages[Index] = 0.f;
+	Radii[Index] = SweepRadius;
+
+	FFlightQuery& Query = Queries[Index];
+	Query.IgnoredOwner = Arrow->GetOwner();
+	Query.Channel = Collision ? Collision->GetCollisionObjectType() : ECC_WorldDynamic;
+	Query.Responses = Collision ? Collision->GetCollisionResponseToChannels() : FCollisionResponseContainer(ECR_Block);
+}
+
+void UProjectileSimSubsystem::Remove(const AProjectile_Arrow_Base* Arrow)
+{
+	const int32 Index = Arrows.IndexOfByKey(Arrow);
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (bIsStepping)
+	{
+		// Indices must stay stable until the step finishes
+		Arrows[Index].Reset();
+		bNeedsCompact = true;
+		return;
+	}
+
+	RemoveAtSwap(Index);
+}
+
+void UProjectileSimSubsystem::Step(float FixedStep)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileSimStep);
+
+	const int32 Count = Arrows.Num();
+	UWorld* World = GetWorld();
+	if (Count == 0 || !World)
+	{
+		return;
+	}
+
+	bIsStepping = true;
+	const uint64 StepOrder = static_cast<uint64>(++StepCounter) << 32;
+
+	// Integrate
+	SweepEnds.SetNumUninitialized(Count);
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		PreviousPositions[Index] = Positions[Index];
+		Velocities[Index].Z += Gravity[Index] * FixedStep;
+		SweepEnds[Index] = Positions[Index] + Velocities[Index] * FixedStep;
+		Ages[Index] += FixedStep;
+	}
+
+	// Resolve ignore lists and pool generations on the game thread so workers only see raw data
+	SweepParams.Reset(Count);
+	SweepGenerations.SetNumUninitialized(Count);
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const AProjectile_Arrow_Base* Arrow = Arrows[Index].Get();
+		FCollisionQueryParams& Params = SweepParams.Emplace_GetRef(SCENE_QUERY_STAT(ArrowFlightSweep), false, Arrow);
+		Params.AddIgnoredActor(Queries[Index].IgnoredOwner.Get());
+		SweepGenerations[Index] = Arrow ? Arrow->GetPoolGeneration() : 0;
+	}
+
+	// Sweep. Hits go straight into the queue from whichever thread found them
+	SweepDidHit.SetNumUninitialized(Count);
+	const bool bSerial = CVarProjectileParallelSweeps.GetValueOnGameThread() == 0;
+	ParallelFor(Count, [&](int32 Index)
+	{
+		const FFlightQuery& Query = Queries[Index];
+		const FCollisionResponseParams ResponseParams(Query.Responses);
+		FHitResult Hit(1.f);
+
+		const bool bHit = Radii[Index] > 0.f
+			? World->SweepSingleByChannel(Hit, Positions[Index], SweepEnds[Index], FQuat::Identity, Query.Channel,
+				FCollisionShape::MakeSphere(Radii[Index]), SweepParams[Index], ResponseParams)
+			: World->LineTraceSingleByChannel(Hit, Positions[Index], SweepEnds[Index], Query.Channel, SweepParams[Index], ResponseParams);
+		SweepDidHit[Index] = bHit ? 1 : 0;
+		if (bHit)
+		{
+			PendingHits.Enqueue({ Arrows[Index], Hit, Velocities[Index], StepOrder | static_cast<uint32>(Index), SweepGenerations[Index] });
+		}
+	}, bSerial);
+
+	// Apply results. The sim only touches its own data and flags here: arrows that hit or expired leave the sim
+	// and wait for ResolveHits, which changes actor and gameplay state in the damage resolution stage
+	const float MaxLifetime = CVarProjectileMaxLifetime.GetValueOnGameThread();
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		AProjectile_Arrow_Base* Arrow = Arrows[Index].Get();
+		if (!Arrow)
+		{
+			bNeedsCompact = true;
+			continue;
+		}
+
+		if (SweepDidHit[Index])
+		{
+			// Out of the sim now, so a later substep this frame can't hit a second target
+			Arrow->MarkImpactPending();
+			Arrows[Index].Reset();
+			bNeedsCompact = true;
+		}
+		else
+		{
+			Positions[Index] = SweepEnds[Index];
+			if (Ages[Index] > MaxLifetime)
+			{
+				ExpiredArrows.Add({ Arrow, Arrow->GetPoolGeneration() });
+				Arrows[Index].Reset();
+				bNeedsCompact = true;
+			}
+		}
+	}
+
+	bIsStepping = false;
+	if (bNeedsCompact)
+	{
+		Compact();
+	}
+
+	SET_DWORD_STAT(STAT_ProjectileSimInFlight, Arrows.Num());
+}
+
+void UProjectileSimSubsystem::ResolveHits()
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileSimResolveHits);
+
+	// Skip expired arrows the pool has handed out again since
+	if (ExpiredArrows.Num() > 0)
+	{
+		if (UProjectilePoolSubsystem* Pool = UProjectilePoolSubsystem::Get(this))
+		{
+			for (const FExpiredArrow& Expired : ExpiredArrows)
+			{
+				AProjectile_Arrow_Base* Arrow = Expired.Arrow.Get();
+				if (Arrow && Arrow->GetPoolGeneration() == Expired.PoolGeneration)
+				{
+					Pool->Release(Arrow);
+				}
+			}
+		}
+		ExpiredArrows.Reset();
+	}
+
+	ResolveBatch.Reset();
+	FPendingHit Pending;
+	while (PendingHits.Dequeue(Pending))
+	{
+		ResolveBatch.Add(MoveTemp(Pending));
+	}
+
+	if (ResolveBatch.Num() == 0)
+	{
+		return;
+	}
+
+	// Workers enqueue in whatever order they finish; step and slot give back the order the sim produced them in
+	ResolveBatch.Sort([](const FPendingHit& A, const FPendingHit& B) { return A.Order < B.Order; });
+
+	// Drop hits recorded in an arrow's previous life; it has been recycled since
+	ResolveBatch.RemoveAll([](const FPendingHit& Hit)
+	{
+		const AProjectile_Arrow_Base* Arrow = Hit.Arrow.Get();
+		return !Arrow || !Arrow->IsImpactPending() || Arrow->GetPoolGeneration() != Hit.PoolGeneration;
+	});
+
+	// One damage event per target and instigator this step, carrying every arrow that struck it,
+	// applied in the order the first of those arrows hit so kills land the same way regardless of thread timing
+	struct FTargetDamage
+	{
+		AActor* Target;
+		AController* Instigator;
+		AProjectile_Arrow_Base* Causer;
+		float Damage;
+	};
+	TArray<FTargetDamage, TInlineAllocator<16>> TargetDamage;
+	for (const FPendingHit& Hit : ResolveBatch)
+	{
+		AProjectile_Arrow_Base* Arrow = Hit.Arrow.Get();
+		AActor* Target = Hit.Hit.GetActor();
+		const float Damage = Arrow->ConsumeImpactDamage();
+		if (!Target || Damage <= 0.f)
+		{
+			continue;
+		}
+
+		AController* Instigator = Arrow->GetInstigatorController();
+		FTargetDamage* Existing = TargetDamage.FindByPredicate([Target, Instigator](const FTargetDamage& Entry)
+		{
+			return Entry.Target == Target && Entry.Instigator == Instigator;
+		});
+		if (Existing)
+		{
+			Existing->Damage += Damage;
+		}
+		else
+		{
+			TargetDamage.Add({ Target, Instigator, Arrow, Damage });
+		}
+	}
+
+	for (const FTargetDamage& Entry : TargetDamage)
+	{
+		// An earlier target's death may have torn this one down
+		if (IsValid(Entry.Target))
+		{
+			Entry.Target->TakeDamage(Entry.Damage, FDamageEvent(), Entry.Instigator, Entry.Causer);
+		}
+	}
+
+	// One sound and effect per spot, however many arrows struck there; keyed by location so world hits don't all share one
+	TSet<FIntVector, DefaultKeyFuncs<FIntVector>, TInlineSetAllocator<16>> EffectCells;
+	for (const FPendingHit& Hit : ResolveBatch)
+	{
+		AProjectile_Arrow_Base* Arrow = Hit.Arrow.Get();
+		bool bCellHadEffect = false;
+		const FVector Cell = Hit.Hit.ImpactPoint / ProjectileSim::EffectCellSize;
+		EffectCells.Add(FIntVector(FMath::FloorToInt32(Cell.X), FMath::FloorToInt32(Cell.Y), FMath::FloorToInt32(Cell.Z)), &bCellHadEffect);
+		if (Arrow && !bCellHadEffect)
+		{
+			Arrow->PlayImpactEffects(Hit.Hit);
+		}
+	}
+
+	// Then stick, instance or recycle the arrows
+	for (const FPendingHit& Hit : ResolveBatch)
+	{
+		AProjectile_Arrow_Base* Arrow = Hit.Arrow.Get();
+		if (Arrow && Arrow->IsImpactPending())
+		{
+			Arrow->ResolveImpact(Hit.Hit, Hit.Velocity);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_ProjectileSimHitsResolved, ResolveBatch.Num());
+	ResolveBatch.Reset();
+}
+
+void UProjectileSimSubsystem::Present(float Alpha)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileSimPresent);
+	const double StartTime = FPlatformTime::Seconds();
+
+	for (int32 Index = 0; Index < Arrows.Num(); ++Index)
+	{
+		if (AProjectile_Arrow_Base* Arrow = Arrows[Index].Get())
+		{
+			const FVector Location = FMath::Lerp(PreviousPositions[Index], Positions[Index], Alpha);
+			Arrow->SetActorLocationAndRotation(Location, Velocities[Index].Rotation(), false, nullptr, ETeleportType::TeleportPhysics);
+		}
+	}
+
+	if (Benchmark.bActive)
+	{
+		TickVolleyBenchmark((FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}
+}
+
+void UProjectileSimSubsystem::StartVolleyBenchmark(TSubclassOf<AProjectile_Arrow_Base> Class, int32 ArrowsPerVolley, int32 Volleys, int32 Interval, float Damage)
+{
+	if (!Class || ArrowsPerVolley <= 0 || Volleys <= 0)
+	{
+		return;
+	}
+
+	// A restarted benchmark puts back the cap from before the first one
+	const int32 SavedMaxArrows = Benchmark.bActive ? Benchmark.SavedMaxArrows : INDEX_NONE;
+	Benchmark = FVolleyBenchmark();
+	Benchmark.SavedMaxArrows = SavedMaxArrows;
+
+	// A volley bigger than the pool cap would recycle its own arrows mid-flight
+	if (IConsoleVariable* MaxArrows = IConsoleManager::Get().FindConsoleVariable(TEXT("Combat.ProjectilePool.MaxArrows")))
+	{
+		if (MaxArrows->GetInt() < ArrowsPerVolley)
+		{
+			if (Benchmark.SavedMaxArrows == INDEX_NONE)
+			{
+				Benchmark.SavedMaxArrows = MaxArrows->GetInt();
+			}
+			MaxArrows->Set(ArrowsPerVolley, ECVF_SetByConsole);
+			UE_LOG(LogTemp, Display, TEXT("Volley benchmark: raised Combat.ProjectilePool.MaxArrows to %d"), ArrowsPerVolley);
+		}
+	}
+
+	Benchmark.Class = Class;
+	Benchmark.Damage = Damage;
+	Benchmark.ArrowsPerVolley = ArrowsPerVolley;
+	Benchmark.Volleys = Volleys;
+	Benchmark.VolleysLeft = Volleys;
+	Benchmark.Interval = FMath::Max(Interval, 1);
+	Benchmark.bActive = true;
+}
+
+void UProjectileSimSubsystem::TickVolleyBenchmark(double PresentMs)
+{
+	const UCombatFrameSubsystem* CombatFrame = UCombatFrameSubsystem::Get(this);
+
+	// Presentation is the last stage, so the sim and resolution timings for this frame are final
+	if (Benchmark.Frame > 0)
+	{
+		const double FrameMs = FApp::GetDeltaTime() * 1000.0;
+		Benchmark.SimMs += CombatFrame ? CombatFrame->GetStageMilliseconds(ECombatFrameStage::ProjectileSim) : 0.0;
+		Benchmark.ResolveMs += CombatFrame ? CombatFrame->GetStageMilliseconds(ECombatFrameStage::DamageResolution) : 0.0;
+		Benchmark.PresentMs += PresentMs;
+		Benchmark.FrameMs += FrameMs;
+		Benchmark.PeakFrameMs = FMath::Max(Benchmark.PeakFrameMs, FrameMs);
+	}
+
+	if (Benchmark.VolleysLeft > 0 && Benchmark.Frame % Benchmark.Interval == 0)
+	{
+		APawn* Player = UGameplayStatics::GetPlayerPawn(this, 0);
+		const FVector Origin = Player ? Player->GetActorLocation() + FVector(0.f, 0.f, 100.f) : FVector::ZeroVector;
+		const FRotator Aim(40.f, Player ? Player->GetActorRotation().Yaw : 0.f, 0.f);
+
+		// Seeded by the volley's index, so every run fires the same spread of volleys
+		FRandomStream Random(Benchmark.Volleys - Benchmark.VolleysLeft);
+		TArray<FVector> Directions;
+		Directions.SetNumUninitialized(Benchmark.ArrowsPerVolley);
+		for (FVector& Direction : Directions)
+		{
+			Direction = Random.VRandCone(Aim.Vector(), FMath::DegreesToRadians(15.f));
+		}
+
+		const double FireStart = FPlatformTime::Seconds();
+		FireVolley(Benchmark.Class, Origin, Directions, 3000.f, Benchmark.Damage, Player);
+		Benchmark.FireMs += (FPlatformTime::Seconds() - FireStart) * 1000.0;
+		--Benchmark.VolleysLeft;
+	}
+
+	// Keep sampling for one more interval after the last volley so it has time to land
+	++Benchmark.Frame;
+	if (Benchmark.Frame <= Benchmark.Volleys * Benchmark.Interval + Benchmark.Interval)
+	{
+		return;
+	}
+
+	const double Frames = Benchmark.Frame - 1;
+	UE_LOG(LogTemp, Display, TEXT("Volley benchmark: %d %s arrows x %d volleys over %d frames"), Benchmark.ArrowsPerVolley,
+		*GetNameSafe(Benchmark.Class), Benchmark.Volleys, Benchmark.Frame - 1);
+	UE_LOG(LogTemp, Display, TEXT("  FireVolley %.3f ms per volley"), Benchmark.FireMs / Benchmark.Volleys);
+	UE_LOG(LogTemp, Display, TEXT("  Per frame: sim %.3f ms, damage resolution %.3f ms, transform sync %.3f ms"),
+		Benchmark.SimMs / Frames, Benchmark.ResolveMs / Frames, Benchmark.PresentMs / Frames);
+	UE_LOG(LogTemp, Display, TEXT("  Frame time %.2f ms average, %.2f ms peak"), Benchmark.FrameMs / Frames, Benchmark.PeakFrameMs);
+	EndVolleyBenchmark();
+}
+
+void UProjectileSimSubsystem::EndVolleyBenchmark()
+{
+	if (Benchmark.SavedMaxArrows != INDEX_NONE)
+	{
+		if (IConsoleVariable* MaxArrows = IConsoleManager::Get().FindConsoleVariable(TEXT("Combat.ProjectilePool.MaxArrows")))
+		{
+			MaxArrows->Set(Benchmark.SavedMaxArrows, ECVF_SetByConsole);
+			UE_LOG(LogTemp, Display, TEXT("Volley benchmark: restored Combat.ProjectilePool.MaxArrows to %d"), Benchmark.SavedMaxArrows);
+		}
+	}
+	Benchmark = FVolleyBenchmark();
+}
+
+void UProjectileSimSubsystem::RemoveAtSwap(int32 Index)
+{
+	Arrows.RemoveAtSwap(Index);
+	Positions.RemoveAtSwap(Index);
+	PreviousPositions.RemoveAtSwap(Index);
+	Velocities.RemoveAtSwap(Index);
+	Gravity.RemoveAtSwap(Index);
+	Ages.RemoveAtSwap(Index);
+	Radii.RemoveAtSwap(Index);
+	Queries.RemoveAtSwap(Index);
+}
+
+void UProjectileSimSubsystem::Compact()
+{
+	for (int32 Index = Arrows.Num() - 1; Index >= 0; --Index)
+	{
+		if (!Arrows[Index].IsValid())
+		{
+			RemoveAtSwap(Index);
+		}
+	}
+	bNeedsCompact = false;
+}
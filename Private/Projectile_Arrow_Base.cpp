@@ -4,31 +4,40 @@
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Engine/DamageEvents.h"
+#include "NiagaraComponent.h"
 #include "NiagaraFunctionLibrary.h"
 #include "NiagaraSystem.h"
 #include "GameFramework/Actor.h"
-#include "Kismet/GameplayStatics.h"
+#include "CombatAudioSubsystem.h"
+#include "CombatFXSubsystem.h"
+#include "ProjectilePoolSubsystem.h"
+#include "ProjectileSimSubsystem.h"
+#include "StuckArrowSubsystem.h"
 
 AProjectile_Arrow_Base::AProjectile_Arrow_Base()
 {
-	// Set this actor to call Tick() every frame
-	PrimaryActorTick.bCanEverTick = true;
+	// Flight is driven by UProjectileSimSubsystem and the trail by its own component, so the arrow never ticks
+	PrimaryActorTick.bCanEverTick = false;
 
 	// Create the arrow mesh component
 	ArrowMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("ArrowMesh"));
 	RootComponent = ArrowMesh;
 
-	// Set up physics and collision
-	ArrowMesh->SetSimulatePhysics(true);
-	ArrowMesh->SetNotifyRigidBodyCollision(true); // Enable hit notifications
+	// No rigid body: UProjectileSimSubsystem flies the arrow and sweeps with the mesh's collision responses
+	ArrowMesh->SetSimulatePhysics(false);
 	ArrowMesh->SetCollisionProfileName(TEXT("Projectile"));
 
 	// Set up the collision response
 	ArrowMesh->SetCollisionResponseToAllChannels(ECR_Block);
 	ArrowMesh->SetCollisionResponseToChannel(ECC_Pawn, ECR_Block); // Make sure it hits characters
+	ArrowMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 
-	// Bind the OnHit event
-	ArrowMesh->OnComponentHit.AddDynamic(this, &AProjectile_Arrow_Base::OnHit);
+	// One trail per arrow, switched on at launch and left to fade out on impact
+	TrailComponent = CreateDefaultSubobject<UNiagaraComponent>(TEXT("TrailComponent"));
+	TrailComponent->SetupAttachment(ArrowMesh);
+	TrailComponent->SetRelativeLocation(FVector(-40.0f, 0.0f, 0.0f)); // Back of the arrow
+	TrailComponent->bAutoActivate = false;
+	TrailComponent->SetAutoDestroy(false);
 
 	// Initialize velocity and speed
 	Velocity = FVector::ZeroVector;
@@ -38,58 +47,106 @@ AProjectile_Arrow_Base::AProjectile_Arrow_Base()
 void AProjectile_Arrow_Base::BeginPlay()
 {
 	Super::BeginPlay();
+
+	if (TrailEffect && TrailComponent)
+	{
+		TrailComponent->SetAsset(TrailEffect);
+		TrailComponent->OnSystemFinished.AddDynamic(this, &AProjectile_Arrow_Base::OnTrailFinished);
+	}
 }
 
-void AProjectile_Arrow_Base::Tick(float DeltaTime)
+void AProjectile_Arrow_Base::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::Tick(DeltaTime);
+	if (UProjectileSimSubsystem* ProjectileSim = UProjectileSimSubsystem::Get(this))
+	{
+		ProjectileSim->Remove(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
 
-	// If the arrow is not using physics, update its position manually
-	if (ArrowMesh && !ArrowMesh->IsSimulatingPhysics() && !Velocity.IsZero())
+void AProjectile_Arrow_Base::FellOutOfWorld(const UDamageType& DamageType)
+{
+	// Missed shots go back to the pool instead of being destroyed
+	if (UProjectilePoolSubsystem* Pool = UProjectilePoolSubsystem::Get(this))
 	{
-		FVector NewLocation = GetActorLocation() + Velocity * DeltaTime;
-		SetActorLocation(NewLocation);
+		Pool->Release(this);
+		return;
 	}
 
-	if (TrailEffect && ArrowMesh && !Velocity.IsZero())
+	Super::FellOutOfWorld(DamageType);
+}
+
+void AProjectile_Arrow_Base::ActivateFromPool(const FTransform& Transform)
+{
+	const AProjectile_Arrow_Base* Defaults = GetClass()->GetDefaultObject<AProjectile_Arrow_Base>();
+	++PoolGeneration;
+	hasCollided = false;
+	DamageAmount = Defaults->DamageAmount;
+	Speed = Defaults->Speed;
+	Velocity = FVector::ZeroVector;
+
+	SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	if (ArrowMesh)
 	{
-		FVector ArrowEndLocation;
-		FRotator ArrowEndRotation;
-        
-		// Calculate the end of the arrow based on its transform
-		FVector ArrowDirection = GetActorForwardVector();
-		float ArrowLength =40.0f; // Adjust this value based on your arrow's actual length
-        
-		// Calculate the position at the back of the arrow (opposite to forward vector)
-		ArrowEndLocation = GetActorLocation() - (ArrowDirection * ArrowLength);
-		ArrowEndRotation = GetActorRotation();
-        
-		// Spawn the trail effect
-		UNiagaraFunctionLibrary::SpawnSystemAtLocation(
-			GetWorld(),
-			TrailEffect,
-			ArrowEndLocation,
-			ArrowEndRotation
-		);
+		ArrowMesh->SetVisibility(true);
+	}
+}
+
+void AProjectile_Arrow_Base::DeactivateToPool()
+{
+	// A recycled arrow must not resolve a hit it recorded in its previous life
+	++PoolGeneration;
+	bImpactPending = false;
+	bReleaseWhenTrailFinished = false;
+	DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	StopArrowMovement();
+	if (TrailComponent)
+	{
+		// Kill any fading particles so a recycled arrow doesn't drag its old trail along
+		TrailComponent->DeactivateImmediate();
 	}
-	
+	SetActorHiddenInGame(true);
+	SetOwner(nullptr);
+	SetInstigator(nullptr);
 }
 
 void AProjectile_Arrow_Base::SetVelocity(const FVector& Vector)
 {
-	Velocity = Vector;
+	PrepareFlight(Vector);
 
-	// Set the arrow's rotation to match its velocity direction
+	UProjectileSimSubsystem* ProjectileSim = UProjectileSimSubsystem::Get(this);
+	if (!ProjectileSim)
+	{
+		return;
+	}
+
+	// Flight continues from wherever the arrow is now
 	if (!Velocity.IsZero())
 	{
-		FRotator NewRotation = Velocity.Rotation();
-		SetActorRotation(NewRotation);
+		ProjectileSim->Launch(this, Velocity, GravityScale, SweepRadius);
+	}
+	else
+	{
+		ProjectileSim->Remove(this);
+	}
+}
 
-		// Apply the velocity to the physics object
-		if (ArrowMesh && ArrowMesh->IsSimulatingPhysics())
-		{
-			ArrowMesh->SetPhysicsLinearVelocity(Velocity);
-		}
+void AProjectile_Arrow_Base::PrepareFlight(const FVector& Vector)
+{
+	Velocity = Vector;
+	if (Velocity.IsZero())
+	{
+		return;
+	}
+
+	// Set the arrow's rotation to match its velocity direction
+	SetActorRotation(Velocity.Rotation());
+
+	if (TrailComponent && TrailComponent->GetAsset() && !TrailComponent->IsActive())
+	{
+		TrailComponent->Activate(true);
 	}
 }
 
@@ -103,133 +160,191 @@ void AProjectile_Arrow_Base::Scale(double X)
 	ArrowMesh->SetWorldScale3D(FVector(X, X, X));
 }
 
-void AProjectile_Arrow_Base::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp,
-                                   FVector NormalImpulse, const FHitResult& Hit)
+void AProjectile_Arrow_Base::MarkImpactPending()
 {
-	// Early return if invalid hit
-	if (!OtherActor || OtherActor == this || OtherActor == GetOwner() || !ArrowMesh || !OtherComp)
-	{
-		return;
-	}
-
+	// Counts as collided straight away, so a cancelled quick attack doesn't refund a bolt that already hit
 	hasCollided = true;
-	// Apply damage
-	FDamageEvent DamageEvent;
-	OtherActor->TakeDamage(DamageAmount, DamageEvent, GetInstigatorController(), this);
+	bImpactPending = true;
+}
+
+float AProjectile_Arrow_Base::ConsumeImpactDamage()
+{
+	const float Damage = DamageAmount;
 	DamageAmount = 0.0f;
+	return Damage;
+}
 
-	UGameplayStatics::PlaySoundAtLocation(
+void AProjectile_Arrow_Base::PlayImpactEffects(const FHitResult& Hit)
+{
+	UCombatAudioSubsystem::PlayCue(
 			this,           // World context object
 			ArrowHitSound,// Sound to play
-			GetActorLocation(), // Location to play sound
-			0.2f,           // Volume multiplier
-			1.0f,           // Pitch multiplier
-			0.0f,           // Start time
-			nullptr,        // Attenuation settings
-			nullptr         // Concurrency settings
+			Hit.Location, // Location to play sound
+			ECombatAudioCategory::Impact,
+			0.2f            // Volume multiplier
 		);
 
 	if (HitEffect) // Ensure effect is assigned
 	{
-		// Get hit location from damage event if possible
-		FVector HitLocation = GetActorLocation(); // Default to actor location
-		FRotator HitRotation = GetActorRotation(); // Default rotation
-        
-		// Try to get more accurate hit information if available
-		if (DamageEvent.IsOfType(FPointDamageEvent::ClassID))
+		// Spawn the effect where the arrow struck, facing out of the surface
+		UCombatFXSubsystem::SpawnAtLocation(
+			this,          // World context
+			HitEffect,     // Niagara system to spawn
+			Hit.ImpactPoint,   // Location of the hit
+			Hit.ImpactNormal.Rotation(),    // Rotation to align with surface
+			ECombatFXPriority::Cosmetic // Volleys land many at once; the damage and sound matter more
+		);
+	}
+}
+
+void AProjectile_Arrow_Base::ResolveImpact(const FHitResult& Hit, const FVector& ImpactVelocity)
+{
+	bImpactPending = false;
+
+	AActor* OtherActor = Hit.GetActor();
+	UPrimitiveComponent* OtherComp = Hit.GetComponent();
+
+	// The sweep already ignores this arrow and its owner; anything else without an actor has nothing to stick to,
+	// so the arrow goes straight back to the pool rather than lingering until the pool reclaims it
+	if (!OtherActor || !ArrowMesh || !OtherComp)
+	{
+		StopArrowMovement();
+		if (UProjectilePoolSubsystem* Pool = UProjectilePoolSubsystem::Get(this))
 		{
-			// If it's point damage, we can get the exact hit location
-			const FPointDamageEvent* PointDamageEvent = static_cast<const FPointDamageEvent*>(&DamageEvent);
-			HitLocation = PointDamageEvent->HitInfo.ImpactPoint;
-			HitRotation = PointDamageEvent->HitInfo.ImpactNormal.Rotation();
+			Pool->Release(this);
 		}
-		else if (DamageEvent.IsOfType(FRadialDamageEvent::ClassID))
+		return;
+	}
+
+	Velocity = ImpactVelocity;
+	SetActorLocation(Hit.Location);
+
+	// Handle arrow attachment based on what was hit, while the impact velocity still gives its rotation
+	const bool bInstanced = AttachArrowToTarget(OtherActor, OtherComp, Hit);
+
+	// Stop arrow movement
+	StopArrowMovement();
+
+	if (UProjectilePoolSubsystem* Pool = UProjectilePoolSubsystem::Get(this))
+	{
+		if (bInstanced)
 		{
-			// For radial damage, use the origin of the explosion
-			const FRadialDamageEvent* RadialDamageEvent = static_cast<const FRadialDamageEvent*>(&DamageEvent);
-			HitLocation = RadialDamageEvent->Origin;
+			// The stuck arrow now lives on as an instance; hide the actor's copy but let the trail fade
+			// out before the actor goes back to the pool for the next shot
+			if (TrailComponent && TrailComponent->IsActive())
+			{
+				ArrowMesh->SetVisibility(false);
+				bReleaseWhenTrailFinished = true;
+			}
+			else
+			{
+				Pool->Release(this);
+			}
+		}
+		else
+		{
+			// Stuck arrows stay visible until the pool needs them back
+			Pool->NotifyStuck(this);
 		}
-        
-		// Spawn the effect at the hit location
-		UNiagaraFunctionLibrary::SpawnSystemAtLocation(
-			GetWorld(),    // Get world context
-			HitEffect,     // Niagara system to spawn
-			HitLocation,   // Location of the hit
-			HitRotation    // Rotation to align with surface
-		);
 	}
+}
 
-	// Stop arrow physics and movement
-	StopArrowMovement();
+void AProjectile_Arrow_Base::OnTrailFinished(UNiagaraComponent* FinishedComponent)
+{
+	if (!bReleaseWhenTrailFinished)
+	{
+		return;
+	}
 
-	// Handle arrow attachment based on what was hit
-	AttachArrowToTarget(OtherActor, OtherComp, Hit);
+	bReleaseWhenTrailFinished = false;
+	if (UProjectilePoolSubsystem* Pool = UProjectilePoolSubsystem::Get(this))
+	{
+		Pool->Release(this);
+	}
 }
 
 void AProjectile_Arrow_Base::StopArrowMovement()
 {
+	if (UProjectileSimSubsystem* ProjectileSim = UProjectileSimSubsystem::Get(this))
+	{
+		ProjectileSim->Remove(this);
+	}
+
 	if (ArrowMesh)
 	{
-		ArrowMesh->SetSimulatePhysics(false);
 		ArrowMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-		ArrowMesh->SetPhysicsLinearVelocity(FVector::ZeroVector);
 		Velocity = FVector::ZeroVector;
 		Speed = 0.0f;
 	}
+
+	if (TrailComponent)
+	{
+		// Stops spawning; live particles finish on their own and the component deactivates itself
+		TrailComponent->Deactivate();
+	}
 }
 
-void AProjectile_Arrow_Base::AttachArrowToTarget(AActor* HitActor, UPrimitiveComponent* HitComponent,
+bool AProjectile_Arrow_Base::AttachArrowToTarget(AActor* HitActor, UPrimitiveComponent* HitComponent,
                                                  const FHitResult& Hit)
 {
 	if (!ArrowMesh || !HitComponent)
 	{
-		return;
+		return false;
 	}
 
+	USceneComponent* AttachParent;
+	FName AttachName = NAME_None;
+	FVector StuckLocation;
+
 	// Try to find skeletal mesh for character hits
 	USkeletalMeshComponent* SkeletalMesh = HitActor->FindComponentByClass<USkeletalMeshComponent>();
 
 	if (SkeletalMesh)
 	{
+		AttachParent = SkeletalMesh;
+
 		// Try socket attachment first
 		FName SocketName = TEXT("ArrowSocket");
 		if (SkeletalMesh->DoesSocketExist(SocketName))
 		{
-			// Attach to socket
-			ArrowMesh->AttachToComponent(SkeletalMesh, FAttachmentTransformRules::KeepWorldTransform, SocketName);
+			AttachName = SocketName;
 		}
 		else
 		{
 			// Fall back to bone attachment
-			FName BoneName = Hit.BoneName;
-			if (BoneName == NAME_None)
+			AttachName = Hit.BoneName;
+			if (AttachName == NAME_None)
 			{
-				BoneName = SkeletalMesh->GetBoneName(0);
+				AttachName = SkeletalMesh->GetBoneName(0);
 			}
-
-			ArrowMesh->AttachToComponent(SkeletalMesh, FAttachmentTransformRules::KeepWorldTransform, BoneName);
 		}
 
-		// Set correct position and rotation
-		ArrowMesh->SetWorldLocation(Hit.ImpactPoint);
-		ArrowMesh->SetWorldRotation(Velocity.Rotation());
+		StuckLocation = Hit.ImpactPoint;
 	}
 	else
 	{
 		// For static objects (walls, etc.)
-		ArrowMesh->AttachToComponent(HitComponent, FAttachmentTransformRules::KeepWorldTransform);
+		AttachParent = HitComponent;
 
 		// Adjust arrow position to be slightly offset from the surface
 		FVector SurfaceNormal = Hit.ImpactNormal;
-		FVector AdjustedLocation = Hit.ImpactPoint - (SurfaceNormal * 5.0f); // Small offset to prevent clipping
+		StuckLocation = Hit.ImpactPoint - (SurfaceNormal * 5.0f); // Small offset to prevent clipping
+	}
 
-		ArrowMesh->SetWorldLocation(AdjustedLocation);
+	// Rotation follows the flight direction
+	const FRotator StuckRotation = Velocity.Rotation();
 
-		// Calculate rotation to align with surface
-		FRotator ArrowRotation = Velocity.Rotation();
-		ArrowMesh->SetWorldRotation(ArrowRotation);
+	// Prefer an instance on the target over keeping this actor around
+	UStuckArrowSubsystem* StuckArrows = UStuckArrowSubsystem::Get(this);
+	if (StuckArrows && StuckArrows->AddStuckArrow(ArrowMesh->GetStaticMesh(), FTransform(StuckRotation, StuckLocation, ArrowMesh->GetComponentScale()), AttachParent, AttachName))
+	{
+		return true;
 	}
 
+	ArrowMesh->AttachToComponent(AttachParent, FAttachmentTransformRules::KeepWorldTransform, AttachName);
+	ArrowMesh->SetWorldLocationAndRotation(StuckLocation, StuckRotation);
+
 	// Optional: Play impact effects
 	//PlayImpactEffects(Hit);
+	return false;
 }
@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SEnemyHealthBars.h"
+#include "Rendering/DrawElements.h"
+#include "Styling/CoreStyle.h"
+
+namespace EnemyHealthBars
+{
+	static const FVector2D BarSize(100.f, 15.f); // At scale 1, in viewport pixels
+	static const FLinearColor BackgroundColor(0.02f, 0.02f, 0.02f, 0.75f);
+	static const FLinearColor FillColor(0.7f, 0.03f, 0.03f, 1.f);
+}
+
+void SEnemyHealthBars::Construct(const FArguments& InArgs)
+{
+	Brush = FCoreStyle::Get().GetBrush(TEXT("GenericWhiteBox"));
+	SetCanTick(false);
+	SetVisibility(EVisibility::HitTestInvisible);
+}
+
+void SEnemyHealthBars::SetBars(TArray<FEnemyHealthBar>& NewBars)
+{
+	bool bChanged = NewBars.Num() != Bars.Num();
+	for (int32 Index = 0; !bChanged && Index < Bars.Num(); ++Index)
+	{
+		bChanged = !LooksSame(Bars[Index], NewBars[Index]);
+	}
+
+	Swap(Bars, NewBars);
+	if (bChanged)
+	{
+		Invalidate(EInvalidateWidgetReason::Paint);
+	}
+}
+
+bool SEnemyHealthBars::LooksSame(const FEnemyHealthBar& A, const FEnemyHealthBar& B)
+{
+	// Sub-pixel moves and fill changes smaller than a pixel of the widest bar aren't worth a repaint
+	return FMath::Abs(A.Position.X - B.Position.X) < 0.5f
+		&& FMath::Abs(A.Position.Y - B.Position.Y) < 0.5f
+		&& FMath::Abs(A.Scale - B.Scale) < 0.01f
+		&& FMath::Abs(A.Fraction - B.Fraction) < 1.f / EnemyHealthBars::BarSize.X;
+}
+
+int32 SEnemyHealthBars::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
+	FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	// Bars come in viewport pixels; the layer fills the viewport, so only the DPI scale is left to undo
+	const float PixelsToLocal = 1.f / FMath::Max(AllottedGeometry.Scale, KINDA_SMALL_NUMBER);
+	for (const FEnemyHealthBar& Bar : Bars)
+	{
+		const FVector2D Size = EnemyHealthBars::BarSize * Bar.Scale * PixelsToLocal;
+		const FVector2D TopLeft = Bar.Position * PixelsToLocal - Size * 0.5f;
+
+		FSlateDrawElement::MakeBox(OutDrawElements, LayerId,
+			AllottedGeometry.ToPaintGeometry(Size, FSlateLayoutTransform(TopLeft)),
+			Brush, ESlateDrawEffect::None, EnemyHealthBars::BackgroundColor);
+		FSlateDrawElement::MakeBox(OutDrawElements, LayerId + 1,
+			AllottedGeometry.ToPaintGeometry(FVector2D(Size.X * FMath::Clamp(Bar.Fraction, 0.f, 1.f), Size.Y), FSlateLayoutTransform(TopLeft)),
+			Brush, ESlateDrawEffect::None, EnemyHealthBars::FillColor);
+	}
+	return LayerId + 1;
+}
+
+FVector2D SEnemyHealthBars::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	return FVector2D::ZeroVector;
+}
@@ -0,0 +1,156 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "StuckArrowSubsystem.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarStuckArrowsMaxInstances(
+	TEXT("Combat.StuckArrows.MaxInstances"),
+	256,
+	TEXT("Most spent arrows kept visible in targets and walls. The oldest is hidden when a new one lands past the cap."));
+
+UStuckArrowSubsystem* UStuckArrowSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UStuckArrowSubsystem>() : nullptr;
+}
+
+bool UStuckArrowSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UStuckArrowSubsystem::Deinitialize()
+{
+	// The instance components are owned by the actors they're attached to
+	Groups.Empty();
+	Fifo.Empty();
+	FifoHead = 0;
+	FifoCount = 0;
+
+	Super::Deinitialize();
+}
+
+bool UStuckArrowSubsystem::AddStuckArrow(UStaticMesh* Mesh, const FTransform& WorldTransform, USceneComponent* Surface, FName AttachName)
+{
+	if (!Mesh || !IsValid(Surface) || !Surface->GetOwner())
+	{
+		return false;
+	}
+
+	const int32 MaxInstances = CVarStuckArrowsMaxInstances.GetValueOnGameThread();
+	if (MaxInstances <= 0)
+	{
+		// Budget of zero: the arrow simply disappears on impact
+		return true;
+	}
+
+	ResizeFifo(MaxInstances);
+	if (FifoCount == Fifo.Num())
+	{
+		EvictOldest();
+	}
+
+	const FGroupKey Key{ Surface, AttachName, Mesh };
+	FGroup* Group = FindOrCreateGroup(Key, Mesh, Surface);
+	UHierarchicalInstancedStaticMeshComponent* Instances = Group ? Group->Instances.Get() : nullptr;
+	if (!Instances)
+	{
+		return false;
+	}
+
+	const FTransform LocalTransform = WorldTransform.GetRelativeTransform(Instances->GetComponentTransform());
+	int32 Index;
+	if (Group->FreeIndices.Num() > 0)
+	{
+		Index = Group->FreeIndices.Pop();
+		Instances->UpdateInstanceTransform(Index, LocalTransform, false, true, true);
+	}
+	else
+	{
+		Index = Instances->AddInstance(LocalTransform);
+	}
+
+	Fifo[(FifoHead + FifoCount) % Fifo.Num()] = { Key, Group->Generation, Index };
+	++FifoCount;
+	return true;
+}
+
+UStuckArrowSubsystem::FGroup* UStuckArrowSubsystem::FindOrCreateGroup(const FGroupKey& Key, UStaticMesh* Mesh, USceneComponent* Surface)
+{
+	FGroup& Group = Groups.FindOrAdd(Key);
+	if (Group.Instances.IsValid())
+	{
+		return &Group;
+	}
+
+	// First arrow in this group, or the old component went away with its instances. A new generation
+	// leaves any queued entries for the old component to be skipped when they come up for eviction
+	Group.Generation = ++NextGroupGeneration;
+
+	AActor* SurfaceOwner = Surface->GetOwner();
+	UHierarchicalInstancedStaticMeshComponent* Instances = NewObject<UHierarchicalInstancedStaticMeshComponent>(SurfaceOwner);
+	Instances->SetStaticMesh(Mesh);
+	Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Instances->SetCanEverAffectNavigation(false);
+	Instances->SetMobility(EComponentMobility::Movable);
+	Instances->SetupAttachment(Surface, Key.AttachName);
+	Instances->RegisterComponent();
+	SurfaceOwner->AddInstanceComponent(Instances);
+
+	Group.Instances = Instances;
+	Group.FreeIndices.Reset();
+	return &Group;
+}
+
+void UStuckArrowSubsystem::ResizeFifo(int32 Capacity)
+{
+	if (Fifo.Num() == Capacity)
+	{
+		return;
+	}
+
+	// Only when the cap changes: keep the newest entries that still fit, oldest first from slot 0
+	while (FifoCount > Capacity)
+	{
+		EvictOldest();
+	}
+
+	TArray<FStuckInstance> Resized;
+	Resized.SetNum(Capacity);
+	for (int32 Offset = 0; Offset < FifoCount; ++Offset)
+	{
+		Resized[Offset] = Fifo[(FifoHead + Offset) % Fifo.Num()];
+	}
+	Fifo = MoveTemp(Resized);
+	FifoHead = 0;
+}
+
+void UStuckArrowSubsystem::EvictOldest()
+{
+	const FStuckInstance Oldest = Fifo[FifoHead];
+	FifoHead = (FifoHead + 1) % Fifo.Num();
+	--FifoCount;
+
+	FGroup* Group = Groups.Find(Oldest.Key);
+	if (!Group || Group->Generation != Oldest.Generation)
+	{
+		// Its component went away and the slot now belongs to a newer one, if any
+		return;
+	}
+
+	UHierarchicalInstancedStaticMeshComponent* Instances = Group->Instances.Get();
+	if (!Instances)
+	{
+		// The target was destroyed, taking its arrows with it
+		Groups.Remove(Oldest.Key);
+		return;
+	}
+
+	// Hide rather than remove, so the other instance indices in this group stay valid
+	Instances->UpdateInstanceTransform(Oldest.Index, FTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector), false, true, true);
+	Group->FreeIndices.Add(Oldest.Index);
+}
@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "PlayerGlyphComponent.h"
+#include "Components/SpotLightComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Materials/Material.h"
+#include "Misc/ScopeExit.h"
+#include "MyProjectTest2/CPP_Repo/MyProjectTest2Character.h"
+#include "UObject/UObjectArray.h"
+
+namespace PlayerGlyphTest
+{
+	// Counts every UObject created while it is alive
+	struct FObjectCreationCounter : public FUObjectArray::FUObjectCreateListener
+	{
+		FObjectCreationCounter()
+		{
+			GUObjectArray.AddUObjectCreateListener(this);
+		}
+
+		virtual ~FObjectCreationCounter() override
+		{
+			if (bListening)
+			{
+				GUObjectArray.RemoveUObjectCreateListener(this);
+			}
+		}
+
+		virtual void NotifyUObjectCreated(const UObjectBase* Object, int32 Index) override
+		{
+			++Created;
+		}
+
+		virtual void OnUObjectArrayShutdown() override
+		{
+			GUObjectArray.RemoveUObjectCreateListener(this);
+			bListening = false;
+		}
+
+		int32 Created = 0;
+		bool bListening = true;
+	};
+
+	constexpr float FrameTime = 1.0f / 60.0f;
+	constexpr int32 MaxFramesPerCycle = 600;
+	constexpr int32 MeasuredCycles = 3;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlayerGlyphHealCycleAllocationTest, "MyProjectTest2.Player.Glyph.HealCycleAllocatesNothingAfterWarmup",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FPlayerGlyphHealCycleAllocationTest::RunTest(const FString& Parameters)
+{
+	using namespace PlayerGlyphTest;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	ON_SCOPE_EXIT
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	};
+
+	AMyProjectTest2Character* Character = World->SpawnActor<AMyProjectTest2Character>();
+	if (!TestNotNull(TEXT("Character spawned"), Character))
+	{
+		return false;
+	}
+
+	UPlayerGlyphComponent* Glyph = Character->GlyphComponent;
+	if (!TestNotNull(TEXT("Character has a glyph component"), Glyph))
+	{
+		return false;
+	}
+
+	// The glyph mesh and light come from the Blueprint; stand in for them with bare components
+	UStaticMeshComponent* GlyphMesh = NewObject<UStaticMeshComponent>(Character);
+	GlyphMesh->SetMaterial(0, UMaterial::GetDefaultMaterial(MD_Surface));
+	Character->HealingGlyphMesh = GlyphMesh;
+	Character->HealingGlyphLight = NewObject<USpotLightComponent>(Character);
+
+	// Skip BeginPlay and drive the material fade path directly
+	Glyph->Character = Character;
+	Glyph->FadeParameters = nullptr;
+
+	auto RunHealCycle = [Character, Glyph]()
+	{
+		Glyph->Show();
+		for (int32 Frame = 0; Character->bIsHealingGlyphActive && Frame < MaxFramesPerCycle; ++Frame)
+		{
+			Glyph->TickActivity(FrameTime);
+		}
+		return !Character->bIsHealingGlyphActive;
+	};
+
+	// The first heal makes the dynamic material
+	TestTrue(TEXT("Warm-up heal cycle finished"), RunHealCycle());
+	UMaterialInstanceDynamic* WarmMaterial = Glyph->GlyphMaterial;
+	TestNotNull(TEXT("Warm-up created the glyph material"), WarmMaterial);
+
+	int32 Created = 0;
+	{
+		FObjectCreationCounter Counter;
+		for (int32 Cycle = 0; Cycle < MeasuredCycles; ++Cycle)
+		{
+			TestTrue(TEXT("Heal cycle finished"), RunHealCycle());
+		}
+		Created = Counter.Created;
+	}
+
+	TestEqual(TEXT("UObjects created by heal cycles after warm-up"), Created, 0);
+	TestTrue(TEXT("Glyph material reused across heals"), Glyph->GlyphMaterial == WarmMaterial);
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
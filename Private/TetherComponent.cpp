@@ -0,0 +1,173 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TetherComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMeshSocket.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+UTetherComponent::UTetherComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	// Read the source pose after it has been evaluated this frame
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+}
+
+void UTetherComponent::Fire(USkeletalMeshComponent* SourceMesh, FName SocketName, AActor* InTarget)
+{
+	Source = SourceMesh;
+	Target = InTarget;
+	SourceBoneIndex = INDEX_NONE;
+	SocketLocalTransform = FTransform::Identity;
+
+	if (SourceMesh)
+	{
+		// Resolve the socket to a bone index once instead of looking it up by name every tick
+		if (const USkeletalMeshSocket* Socket = SourceMesh->GetSocketByName(SocketName))
+		{
+			SourceBoneIndex = SourceMesh->GetBoneIndex(Socket->BoneName);
+			SocketLocalTransform = Socket->GetSocketLocalTransform();
+		}
+		else
+		{
+			SourceBoneIndex = SourceMesh->GetBoneIndex(SocketName);
+		}
+	}
+
+	if (!UpdateSource() || !Target.IsValid())
+	{
+		SetState(ETetherState::Idle);
+		return;
+	}
+
+	// Re-firing restarts the extension even if the tether was already out
+	State = ETetherState::Idle;
+	StateStartLength = 0.f;
+	CurrentLength = 0.f;
+	SetState(ETetherState::Extending);
+	SetComponentTickEnabled(true);
+}
+
+void UTetherComponent::Release()
+{
+	if (State == ETetherState::Extending || State == ETetherState::Latched)
+	{
+		StateStartLength = CurrentLength;
+		SetState(ETetherState::Retracting);
+	}
+}
+
+void UTetherComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	if (!UpdateSource())
+	{
+		SetState(ETetherState::Idle);
+		return;
+	}
+
+	const AActor* TargetActor = Target.Get();
+	float DistanceToTarget = MaxLength;
+	if (TargetActor)
+	{
+		const FVector ToTarget = TargetActor->GetActorLocation() - SourceLocation;
+		DistanceToTarget = ToTarget.Size();
+		Direction = DistanceToTarget > KINDA_SMALL_NUMBER ? ToTarget / DistanceToTarget : Direction;
+	}
+	else if (State != ETetherState::Retracting)
+	{
+		// Target went away mid-flight
+		StateStartLength = CurrentLength;
+		SetState(ETetherState::Retracting);
+	}
+
+	const float Elapsed = static_cast<float>(GetWorld()->GetTimeSeconds() - StateStartTime);
+	switch (State)
+	{
+	case ETetherState::Extending:
+		CurrentLength = FMath::Min(StateStartLength + ExtendSpeed * Elapsed, MaxLength);
+		if (CurrentLength >= DistanceToTarget)
+		{
+			CurrentLength = DistanceToTarget;
+			SetState(ETetherState::Latched);
+			ApplyPull();
+		}
+		else if (CurrentLength >= MaxLength)
+		{
+			// Missed: out of reach
+			StateStartLength = CurrentLength;
+			SetState(ETetherState::Retracting);
+		}
+		break;
+	case ETetherState::Latched:
+		CurrentLength = FMath::Min(DistanceToTarget, MaxLength);
+		if (Elapsed >= LatchedDuration)
+		{
+			StateStartLength = CurrentLength;
+			SetState(ETetherState::Retracting);
+		}
+		break;
+	case ETetherState::Retracting:
+		CurrentLength = FMath::Max(StateStartLength - RetractSpeed * Elapsed, 0.f);
+		if (CurrentLength <= 0.f)
+		{
+			// Going idle may destroy the owner, so there is nothing left to update
+			SetState(ETetherState::Idle);
+			return;
+		}
+		break;
+	default:
+		break;
+	}
+
+	OnTetherUpdated.Broadcast(*this);
+}
+
+void UTetherComponent::SetState(ETetherState NewState)
+{
+	if (State == NewState)
+	{
+		return;
+	}
+
+	State = NewState;
+	if (const UWorld* World = GetWorld())
+	{
+		StateStartTime = World->GetTimeSeconds();
+	}
+
+	if (State == ETetherState::Idle)
+	{
+		CurrentLength = 0.f;
+		SetComponentTickEnabled(false);
+	}
+
+	OnStateChanged.Broadcast(State);
+}
+
+bool UTetherComponent::UpdateSource()
+{
+	const USkeletalMeshComponent* SourceMesh = Source.Get();
+	if (!SourceMesh || SourceBoneIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// GetBoneTransform reads the cached component space pose, no name lookup or re-evaluation
+	SourceLocation = (SocketLocalTransform * SourceMesh->GetBoneTransform(SourceBoneIndex)).GetLocation();
+	return true;
+}
+
+void UTetherComponent::ApplyPull() const
+{
+	const ACharacter* TargetCharacter = Cast<ACharacter>(Target.Get());
+	if (PullStrength <= 0.f || !TargetCharacter || !TargetCharacter->GetCharacterMovement())
+	{
+		return;
+	}
+
+	TargetCharacter->GetCharacterMovement()->AddImpulse(-Direction * PullStrength, true);
+}
@@ -4,10 +4,12 @@
 #include "AIController.h"
 #include "GameFramework/Character.h"
 #include "Components/CapsuleComponent.h"
-#include "Components/WidgetComponent.h"
 #include "MyProjectTest2/CPP_Repo/MyProjectTest2Character.h"
 #include "AI_Character.generated.h"
 
+class UCurveFloat;
+struct FCombatSnapshot;
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnCharacterDeathSignature, AAI_Character*, DeadCharacter);
 UCLASS()
 
@@ -45,16 +47,22 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Combat")
 	float DamageStateStunDuration = 1.0f;
 	
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "UI")
-    UWidgetComponent* HealthBarWidget;
-	FTimerHandle HealthBarTimerHandle;
-
 	UPROPERTY(BlueprintReadOnly, Category = "Animation")
 	float CurrentHealth = 100.f;
+	// Health bar drain from HealthLerpFromHealth to TargetHealth, advanced by the health bar layer while it runs
 	bool bIsHealthLerping = false;
-	double HealthLerpStartTime;
-	float HealthLerpDuration;
-	FTimerHandle HealthLerpTimerHandle;
+	double HealthLerpStartTime = 0.0;
+	float HealthLerpFromHealth = 100.f;
+
+	UPROPERTY(EditAnywhere, Category = "Health")
+	float HealthLerpDuration = 0.75f; // Seconds for the bar to drain to the new health
+
+	UPROPERTY(EditAnywhere, Category = "Health")
+	UCurveFloat* HealthLerpCurve = nullptr; // Drain progress over normalized time; ease out when unset
+
+	// Kept so blueprints that still read it load; the bar is drawn by UEnemyHealthBarSubsystem and this is destroyed on BeginPlay
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "UI", meta = (DeprecatedProperty, DeprecationMessage = "Health bars are drawn by UEnemyHealthBarSubsystem; remove the widget component from the blueprint."))
+	class UWidgetComponent* HealthBarWidget = nullptr;
 	bool bHasAppliedDamageInCurrentAttack = false;
 
 	UPROPERTY(EditAnywhere, Category="Effects")
@@ -74,11 +82,16 @@ public:
 
 	UPROPERTY(BlueprintReadOnly, Category = "AI Status", meta = (AllowPrivateAccess = "true"))
 	bool bIsDead = false;
-	float FootstepTimer = 0.f;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio")
 	USoundBase* WalkingSound;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio")
+	USoundBase* CrowdFootstepLoop; // Looping layer that stands in for far away grunts' footsteps
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio")
+	float FootstepStrideLength = 160.f;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera")
 	UCameraComponent* CameraRef;
 	
@@ -89,6 +102,7 @@ public:
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	//float GetHealthPercent() const;
 
 public:	
@@ -104,7 +118,13 @@ public:
 	void SpawnHealingEffect(AMyProjectTest2Character* PlayerCharacter);
 	float TakeDamage(float DamageAmount, struct FDamageEvent const& DamageEvent, class AController* EventInstigator,
 	                 AActor* DamageCauser);
-	void UpdateHealthLerp();
+	void StartHealthLerp();
+	/** Moves CurrentHealth along the drain curve at Now. Returns false once the drain has finished */
+	bool UpdateHealthLerp(double Now);
+
+	/** Health bars are drawn by UEnemyHealthBarSubsystem: shown once hurt, until dead and done draining */
+	bool ShouldShowHealthBar() const { return CurrentHealth < MaxHealth && !(bIsDead && !bIsHealthLerping); }
+	float GetHealthBarFraction() const { return MaxHealth > 0.f ? CurrentHealth / MaxHealth : 0.f; }
 	void ExitDamageState();
 	bool IsPendingKill();
 
@@ -131,7 +151,6 @@ private:
     
 	// Whether the AI can currently attack
 	bool bCanAttack;
-	float ErrorTolerance = 5.f;
 
 	// Function to reset attack cooldown
 	void ResetAttackCooldown();
@@ -160,5 +179,29 @@ private:
 
 	FTimerHandle AttackFinishTimerHandle;
 	float AttackFinishDelay = 0.5f; 
+
+	// What the decision stage wants the movement stage to do this frame
+	enum class ECombatIntent : uint8
+	{
+		None,
+		Chase,  // Follow the flow field (or a path) towards the player
+		Attack, // Stop and swing
+		Close   // Inside stop radius but outside attack range
+	};
+	ECombatIntent CombatIntent = ECombatIntent::None;
+	FVector FlowFieldDirection = FVector::ZeroVector; // Zero unless chasing along the flow field
+
+	// Combat frame stages
+	void GatherPerceptionInputs();
+	void UpdatePerception(const FCombatSnapshot& Snapshot);
+	void UpdateCombatDecision(const FCombatSnapshot& Snapshot);
+	void ApplyCombatIntent(const FCombatSnapshot& Snapshot);
+
+	// Cached on the game thread for the worker thread stages
+	FVector PerceptionEyeLocation = FVector::ZeroVector;
+	FRotator PerceptionEyeRotation = FRotator::ZeroRotator;
+	FVector PerceptionLocation = FVector::ZeroVector;
+	float PerceptionFOV = 90.f;
+	bool bPerceptionActive = false;
 	
 };
@@ -4,12 +4,15 @@
 
 #include "CoreMinimal.h"
 #include "AI_Character.h"
+#include "CombatMove.h"
 #include "GameFramework/Character.h"
 
 #include "Components/CapsuleComponent.h"
 #include "MyProjectTest2/CPP_Repo/MyProjectTest2Character.h"
 #include "AI_Elite.generated.h"
 
+struct FCombatSnapshot;
+
 UCLASS()
 class MYPROJECTTEST2_API AAI_Elite : public ACharacter
 {
@@ -31,6 +34,12 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category = "Axe Throw")
 	TSubclassOf<class AElite_ThrowableAxe> EliteThrowableAxeClass;
 
+	UPROPERTY(EditDefaultsOnly, Category = "Axe Throw")
+	int32 AxeVolleyCount = 1; // Axes released per throw
+
+	UPROPERTY(EditDefaultsOnly, Category = "Axe Throw")
+	float AxeVolleySpread = 20.f; // Yaw in degrees between neighbouring axes' targets
+
 	UPROPERTY(BlueprintReadOnly, Category = "Animation")
 	bool bIsDead = false;
 	UPROPERTY(BlueprintReadOnly, Category = "Animation")
@@ -103,8 +112,7 @@ public:
 	bool bCanThrowAxe = true;
 	FTimerHandle AxeThrowCooldownTimerHandle;
 	float AxeThrowCooldown = 6.f;
-	FTimerHandle AxeThrowTimerHandle;
-	FTimerHandle AxeThrowCooldownExecutionHandle;
+	FCombatMove AxeThrowMove;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Combat", meta = (AllowPrivateAccess = "true"))
 	UStaticMeshComponent* AxeMesh;
@@ -117,10 +125,10 @@ public:
 
 	UPROPERTY(BlueprintReadOnly, Category = "Animation")
 	bool bUsingChain;
-	FTimerHandle ChainTimerHandle;
 	FTimerHandle ChainCooldownTimerHandle;
 	bool bCanUseChain = true;
-	FTimerHandle ChainExecuteTimerHandle;
+	FCombatMove ChainMove;
+	TWeakObjectPtr<AElite_ChainProjectile> ActiveChain;
 
 	FTimerHandle BlockTimerHandle;
 	bool bCanBlock;
@@ -187,9 +195,22 @@ public:
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	APlayerController* PlayerController;
 	bool bHasFoundPlayer = false;
 
+	// Combat frame stages
+	void GatherPerceptionInputs();
+	void UpdatePerception(const FCombatSnapshot& Snapshot);
+	void UpdateCombatDecision(const FCombatSnapshot& Snapshot);
+
+	// Cached on the game thread for the worker thread perception stage
+	FVector PerceptionEyeLocation = FVector::ZeroVector;
+	FRotator PerceptionEyeRotation = FRotator::ZeroRotator;
+	FVector PerceptionLocation = FVector::ZeroVector;
+	float PerceptionFOV = 90.f;
+	bool bPerceptionActive = false;
+
 public:
 	void AttackPlayer(APawn* Pawn, AController* AIController);
 	void ExecuteKickDamage();
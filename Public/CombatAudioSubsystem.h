@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatAudioSubsystem.generated.h"
+
+class UAudioComponent;
+class USoundBase;
+class USoundConcurrency;
+
+/** Kinds of combat one-shots. Each has its own concurrency limit and priority */
+UENUM()
+enum class ECombatAudioCategory : uint8
+{
+	Footstep,
+	Impact,  // Arrow and melee hits
+	Weapon,  // Swings, releases and throws
+	Damage,
+	Death,
+	Ability, // Summons, shields, stomps
+	Player,  // Cues about the player's own state; never distance culled
+	Count UMETA(Hidden)
+};
+
+struct FCombatAudioStats
+{
+	uint32 Played = 0;
+	uint32 Culled = 0; // Beyond the sound's audible range
+	uint32 Merged = 0; // Folded into the same sound started close by moments earlier
+	uint32 Stolen = 0; // Started by stopping a lower priority voice
+	uint32 Dropped = 0; // Every voice busy with something at least as important, or over the per-frame ceiling with nothing to merge into
+};
+
+/**
+ * Plays every combat one-shot on a fixed set of pooled audio components, capped at Combat.Audio.MaxVoices.
+ * Each category carries a sound concurrency group and a priority: when the voices run out, a new cue takes over the
+ * lowest priority voice if it outranks it, otherwise it is dropped. Cues beyond the sound's max distance from the
+ * listener are culled. A sound that started within Combat.Audio.MergeRadius and Combat.Audio.MergeWindow isn't restarted;
+ * the playing voice gets louder and its Intensity parameter is raised to the number of merged cues instead. At most
+ * Combat.Audio.MaxStartsPerFrame cues start per frame; the rest merge into the closest nearby voice playing the same sound or
+ * are dropped. Player and Death cues are exempt from that cap.
+ */
+UCLASS()
+class MYPROJECTTEST2_API UCombatAudioSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UCombatAudioSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Plays through the world's audio manager, or directly when there is none (e.g. editor preview worlds) */
+	static UAudioComponent* PlayCue(const UObject* WorldContextObject, USoundBase* Sound, const FVector& Location,
+		ECombatAudioCategory Category, float VolumeMultiplier = 1.f, float PitchMultiplier = 1.f);
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Returns the voice the cue plays or was merged into, or null if it was culled or dropped */
+	UAudioComponent* Play(USoundBase* Sound, const FVector& Location, ECombatAudioCategory Category, float VolumeMultiplier, float PitchMultiplier);
+
+	const FCombatAudioStats& GetStats() const { return Stats; }
+
+	/** Sound parameter set to how many cues a voice stands for */
+	static const FName IntensityParameter;
+
+private:
+	struct FVoice
+	{
+		TWeakObjectPtr<UAudioComponent> Component;
+		ECombatAudioCategory Category = ECombatAudioCategory::Footstep;
+	};
+
+	struct FRecentCue
+	{
+		TObjectKey<USoundBase> Sound;
+		FVector Location;
+		double Time = 0.0;
+		TWeakObjectPtr<UAudioComponent> Component;
+		float BaseVolume = 1.f;
+		int32 Requests = 1;
+	};
+
+	static constexpr int32 CategoryCount = static_cast<int32>(ECombatAudioCategory::Count);
+
+	void BeginFrameIfNeeded();
+	UAudioComponent* AcquireVoice(ECombatAudioCategory Category);
+	UAudioComponent* CreateVoice();
+	FRecentCue* FindMergeTarget(const TObjectKey<USoundBase>& Sound, const FVector& Location, float MaxDistance);
+	UAudioComponent* Merge(FRecentCue& Target);
+
+	UPROPERTY()
+	TArray<USoundConcurrency*> CategoryConcurrency;
+
+	TArray<FVoice> Voices;
+	TArray<FRecentCue> RecentCues;
+	uint64 CurrentFrame = MAX_uint64;
+	int32 StartsThisFrame = 0;
+	FVector ListenerLocation = FVector::ZeroVector;
+	bool bHasListener = false;
+
+	FCombatAudioStats Stats;
+};
@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatFXSubsystem.generated.h"
+
+class UNiagaraComponent;
+class UNiagaraSystem;
+
+/** How hard the FX manager tries to keep an effect */
+UENUM()
+enum class ECombatFXPriority : uint8
+{
+	Cosmetic, // Dropped first: distance and off-screen culled, limited to part of the frame budget
+	Impact,   // Hit feedback: distance and off-screen culled, uses the whole frame budget
+	Critical  // Gameplay telegraphs and player feedback: never culled or budgeted
+};
+
+struct FCombatFXStats
+{
+	uint32 Spawned = 0;
+	uint32 Culled = 0; // Too far away or off screen
+	uint32 Coalesced = 0; // Merged into the same effect spawned close by moments earlier
+	uint32 OverBudget = 0; // Dropped by the per-frame or per-effect budget with nothing to merge into
+};
+
+/**
+ * Every combat Niagara spawn goes through here. Effects use the Niagara component pool and are
+ * limited per frame in total (Combat.FX.MaxSpawnsPerFrame) and per system (Combat.FX.MaxSpawnsPerEffect).
+ * A request for a system that spawned within Combat.FX.CoalesceRadius and Combat.FX.CoalesceWindow is merged into
+ * that spawn, which gets its Intensity user parameter raised to the number of merged requests; requests over budget
+ * merge into the closest spawn of their system within a few coalesce radii instead of being dropped when there is one.
+ * Combat.FX.HardCeiling caps the frame budget of non-critical effects. Critical effects are never culled or budgeted.
+ * Non-critical effects beyond Combat.FX.CullDistance or behind the camera are skipped.
+ */
+UCLASS()
+class MYPROJECTTEST2_API UCombatFXSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UCombatFXSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Spawns through the world's FX manager, or directly when there is none (e.g. editor preview worlds) */
+	static UNiagaraComponent* SpawnAtLocation(const UObject* WorldContextObject, UNiagaraSystem* System, const FVector& Location,
+		const FRotator& Rotation = FRotator::ZeroRotator, ECombatFXPriority Priority = ECombatFXPriority::Impact, const FVector& Scale = FVector(1.f));
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+
+	/** Fills the world's Niagara pool for System (up to the asset's pool prime size) so its first spawn doesn't hitch */
+	void Prewarm(UNiagaraSystem* System);
+
+	/** Returns the spawned or merged-into component, or null if the request was culled or dropped */
+	UNiagaraComponent* Spawn(UNiagaraSystem* System, const FVector& Location, const FRotator& Rotation, ECombatFXPriority Priority, const FVector& Scale);
+
+	const FCombatFXStats& GetStats() const { return Stats; }
+
+	/** Niagara user parameter set to how many requests a spawn stands for */
+	static const FName IntensityParameter;
+
+private:
+	struct FRecentSpawn
+	{
+		TObjectKey<UNiagaraSystem> System;
+		FVector Location;
+		double Time = 0.0;
+		TWeakObjectPtr<UNiagaraComponent> Component;
+		int32 Requests = 1;
+	};
+
+	void BeginFrameIfNeeded();
+	bool IsCulled(const FVector& Location) const;
+	FRecentSpawn* FindMergeTarget(const TObjectKey<UNiagaraSystem>& System, const FVector& Location, float MaxDistance);
+	UNiagaraComponent* Merge(FRecentSpawn& Target);
+
+	uint64 CurrentFrame = MAX_uint64;
+	int32 SpawnsThisFrame = 0;
+	TArray<FRecentSpawn> RecentSpawns;
+	TMap<TObjectKey<UNiagaraSystem>, int32> SpawnsPerEffect;
+
+	// Camera at the first request of the frame
+	bool bHasView = false;
+	FVector ViewLocation = FVector::ZeroVector;
+	FVector ViewDirection = FVector::ForwardVector;
+	float ViewCosHalfFOV = 0.f;
+
+	FCombatFXStats Stats;
+};
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatFlowFieldSubsystem.generated.h"
+
+struct FCombatSnapshot;
+
+struct FCombatFlowFieldStats
+{
+	uint32 Builds = 0; // Fields completed and handed to the grunts
+	uint32 CellsExpanded = 0;
+	uint32 Probes = 0; // Cells checked against the navmesh
+	uint32 Samples = 0;
+	uint32 Misses = 0; // Samples outside the field, on cells it couldn't reach or close to the player
+};
+
+/**
+ * One field toward the player shared by every grunt, instead of a navmesh path query per grunt. A square grid of
+ * Combat.FlowField.GridSize cells is laid around the player and each cell is checked against the navmesh the
+ * first time it's reached. Whenever the player enters a new cell, a Dijkstra pass from that cell rebuilds the
+ * field, at most Combat.FlowField.CellsPerStep cells per sim step, while grunts keep sampling the last complete
+ * field. Each cell stores the neighbour to walk to, so a sample is a single array read.
+ * The grid moves with the player once they get near its edge, keeping the navmesh checks of the cells it still covers.
+ */
+UCLASS()
+class MYPROJECTTEST2_API UCombatFlowFieldSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UCombatFlowFieldSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Flat direction to walk from Location toward the player. Returns false when the field has no answer there,
+	 * including within Combat.FlowField.DirectDistance of the player, where callers should path on their own
+	 */
+	bool SampleDirection(const FVector& Location, FVector& OutDirection);
+
+	const FCombatFlowFieldStats& GetStats() const { return Stats; }
+
+private:
+	struct FGrid
+	{
+		FVector Origin = FVector::ZeroVector; // Corner of cell 0, at the height the grid was laid at
+		float CellSize = 0.f;
+		int32 Size = 0; // Cells per side
+
+		bool IsSet() const { return Size > 0; }
+		int32 Num() const { return Size * Size; }
+		bool ToCell(const FVector& Location, int32& OutCell) const;
+		FVector GetCellCenter(int32 Cell) const;
+	};
+
+	struct FField
+	{
+		FGrid Grid;
+		TArray<uint8> Next; // Per cell, the neighbour direction toward the player
+	};
+
+	struct FOpenCell
+	{
+		float Cost;
+		int32 Cell;
+
+		bool operator<(const FOpenCell& Other) const { return Cost < Other.Cost; }
+	};
+
+	enum class ECellState : uint8
+	{
+		Unknown,
+		Walkable,
+		Blocked
+	};
+
+	void UpdateField(const FCombatSnapshot& Snapshot);
+	void LayGrid(const FVector& Center);
+	bool NeedsNewGrid(const FVector& PlayerLocation) const;
+	void StartBuild(int32 SeedCell);
+	bool ContinueBuild(int32 Budget);
+	bool IsWalkable(int32 Cell);
+	bool CanStep(int32 From, int32 To, int32 Direction);
+
+	FGrid Grid; // The grid being built on; Front keeps its own copy until the next build is done
+	TArray<ECellState> CellStates;
+	TArray<float> CellHeights; // Navmesh height, valid once the cell is known to be walkable
+	TArray<ECellState> ShiftedCellStates; // Previous grid's states while they are carried over to a moved grid
+	TArray<float> ShiftedCellHeights;
+	int32 ProbesThisStep = 0;
+
+	FField Front; // Sampled by grunts
+	FField Back; // Being built
+	TArray<float> Costs;
+	TArray<FOpenCell> Open;
+	int32 SeedCell = INDEX_NONE;
+	bool bBuilding = false;
+
+	FVector PlayerLocation = FVector::ZeroVector;
+	bool bHasPlayer = false;
+
+	FCombatFlowFieldStats Stats;
+};
@@ -0,0 +1,153 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatFrameSubsystem.generated.h"
+
+class ACharacter;
+class APawn;
+
+/** Stages of the combat frame, in dependency order */
+UENUM()
+enum class ECombatFrameStage : uint8
+{
+	GatherSnapshot,
+	Perception,
+	Decisions,
+	MovementRequests,
+	ProjectileSim,
+	DamageResolution,
+	Presentation,
+	Count UMETA(Hidden)
+};
+
+struct FCombatEnemySnapshot
+{
+	TWeakObjectPtr<ACharacter> Character;
+	FVector Location = FVector::ZeroVector;
+	float DistanceToPlayer = 0.f;
+};
+
+/** Read-only view of the world gathered on the game thread at the start of every combat frame */
+struct FCombatSnapshot
+{
+	TWeakObjectPtr<APawn> Player;
+	const APawn* PlayerRaw = nullptr; // Identity comparisons only (e.g. trace hits) from worker stages
+	FVector PlayerLocation = FVector::ZeroVector;
+	FVector PlayerVelocity = FVector::ZeroVector;
+	float PlayerSpeed = 0.f;
+	TArray<FCombatEnemySnapshot> Enemies;
+	uint64 FrameNumber = 0;
+	double SimTime = 0.0;
+	float InterpolationAlpha = 0.f; // Presentation only: how far the render frame is past the last sim step
+};
+
+/**
+ * Fixed-step clock for the combat simulation. Render frame time is accumulated and consumed in
+ * whole steps, so the simulation behaves the same at 30 and 144 fps. Leftover time becomes the
+ * interpolation alpha that presentation uses to blend between the last two sim states.
+ */
+struct FCombatSimClock
+{
+	/** Consumes DeltaTime and returns how many fixed steps to run this frame */
+	int32 Advance(float DeltaTime, float FixedStep, int32 MaxSteps);
+
+	int32 StepsThisFrame = 0;
+	float Alpha = 0.f;
+	double SimTime = 0.0;
+
+private:
+	double Accumulator = 0.0;
+};
+
+using FCombatStageWork = TFunction<void(const FCombatSnapshot& Snapshot, float DeltaTime)>;
+
+/**
+ * Runs the combat frame as an explicit pipeline of task graph nodes:
+ * gather snapshot -> perception -> decisions -> movement requests -> projectile sim -> damage resolution -> presentation.
+ * Everything up to damage resolution runs once per fixed sim step; presentation runs once per render frame.
+ * Projectile sim waits for decisions, so its hits never change actor state while a worker stage reads it. Work inside a stage runs in
+ * registration order, so ordering between the player, grunts, boss and projectiles is deterministic.
+ * A stage goes to a worker thread only when every item registered on it is thread safe.
+ */
+UCLASS()
+class MYPROJECTTEST2_API UCombatFrameSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UCombatFrameSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Registers work for a stage. Thread safe work may only touch the snapshot and its owner's own state */
+	void AddStageWork(ECombatFrameStage Stage, const UObject* Owner, FCombatStageWork Work, bool bThreadSafe = false);
+
+	/** Removes every stage work item registered by Owner */
+	void RemoveStageWork(const UObject* Owner);
+
+	void RegisterEnemy(ACharacter* Enemy);
+	void UnregisterEnemy(ACharacter* Enemy);
+	const TArray<TWeakObjectPtr<ACharacter>>& GetEnemies() const { return Enemies; }
+
+	const FCombatSnapshot& GetSnapshot() const { return Snapshot; }
+
+	/** Wall time spent in a stage during the last frame, summed over its sim steps */
+	float GetStageMilliseconds(ECombatFrameStage Stage) const;
+
+	/**
+	 * The sim clock advances at the start of the world tick, so every actor and component sees the same step count this frame.
+	 * Frame-rate independent logic runs GetSimStepsThisFrame() times with GetFixedStep(); presentation blends with GetInterpolationAlpha().
+	 */
+	float GetFixedStep() const;
+	int32 GetSimStepsThisFrame() const { return SimClock.StepsThisFrame; }
+	float GetInterpolationAlpha() const { return SimClock.Alpha; }
+
+private:
+	struct FStageWorkItem
+	{
+		TWeakObjectPtr<const UObject> Owner;
+		const UObject* OwnerKey = nullptr; // Identity only, for removal checks from worker stages
+		FCombatStageWork Work;
+		bool bThreadSafe = false;
+		bool bRemoved = false;
+	};
+
+	struct FPendingStageWork
+	{
+		ECombatFrameStage Stage;
+		FStageWorkItem Item;
+	};
+
+	static constexpr int32 StageCount = static_cast<int32>(ECombatFrameStage::Count);
+
+	void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	FGraphEventRef DispatchStages(ECombatFrameStage FirstStage, ECombatFrameStage LastStage, float DeltaTime);
+	void RunStage(ECombatFrameStage Stage, float DeltaTime);
+	void GatherSnapshot();
+	bool CanRunOffGameThread(ECombatFrameStage Stage) const;
+	void FlushPendingChanges();
+	bool IsRemovalPending(const UObject* Owner) const;
+
+	TArray<FStageWorkItem> StageWork[StageCount];
+	TArray<FPendingStageWork> PendingAdds;
+
+	// Owners removed while the pipeline runs. Stage arrays are only touched by their own stage's task,
+	// so running stages skip these owners and the arrays are pruned once the frame is done
+	TArray<const UObject*> PendingRemovals;
+	mutable FCriticalSection PendingRemovalsLock;
+	std::atomic<int32> NumPendingRemovals = 0;
+	TArray<TWeakObjectPtr<ACharacter>> Enemies;
+	FCombatSnapshot Snapshot;
+	double StageMilliseconds[StageCount] = {};
+	FCombatSimClock SimClock;
+	FDelegateHandle WorldTickStartHandle;
+	bool bIsRunningPipeline = false;
+};
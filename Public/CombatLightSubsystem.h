@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatLightSubsystem.generated.h"
+
+class ULocalLightComponent;
+class USceneComponent;
+
+/** Which requests keep a light when there are more than the budget allows */
+UENUM()
+enum class ECombatLightPriority : uint8
+{
+	Cosmetic, // Impact flashes and other short accents
+	Gameplay, // Lights that show the player's own state, e.g. a held vial
+	Critical  // Telegraphs and ability feedback; only lose their light to each other
+};
+
+UENUM()
+enum class ECombatLightType : uint8
+{
+	Point,
+	Spot
+};
+
+struct FCombatLightRequest
+{
+	ECombatLightType Type = ECombatLightType::Point;
+	ECombatLightPriority Priority = ECombatLightPriority::Cosmetic;
+	TWeakObjectPtr<USceneComponent> AttachTo; // When set, the light follows it and Location/Rotation are relative
+	FVector Location = FVector::ZeroVector;
+	FRotator Rotation = FRotator::ZeroRotator;
+	FLinearColor Color = FLinearColor::White;
+	float Intensity = 1000.f;
+	ELightUnits IntensityUnits = ELightUnits::Unitless;
+	float AttenuationRadius = 500.f;
+	float InnerConeAngle = 0.f; // Spot only
+	float OuterConeAngle = 44.f; // Spot only
+	bool bCastShadows = false;
+	float Duration = 0.f; // Seconds before the fade out starts; 0 keeps the light until it is released
+	float FadeIn = 0.f;
+	float FadeOut = 0.f;
+
+	/** A request that looks like Template (a light set up in the editor) and follows it */
+	static FCombatLightRequest FromTemplate(ULocalLightComponent* Template, ECombatLightPriority Priority);
+};
+
+struct FCombatLightHandle
+{
+	uint32 Id = 0;
+
+	bool IsValid() const { return Id != 0; }
+};
+
+struct FCombatLightStats
+{
+	uint32 Requested = 0;
+	int32 Active = 0; // Requests currently lit
+	int32 Waiting = 0; // Requests currently without a light because of the budget
+	uint32 IntensityUpdates = 0; // Render state updates from fades
+};
+
+/**
+ * Owns a fixed pool of point and spot lights and lends them to gameplay. Code asks for a light somewhere for a while
+ * instead of owning a component; once per frame, in the combat presentation stage, live requests are ranked by priority
+ * and distance to the camera and the first Combat.Lights.MaxActive get a pooled light. Fades run in the same pass and
+ * only push a new intensity to the renderer when it moved by more than Combat.Lights.IntensityStep.
+ */
+UCLASS()
+class MYPROJECTTEST2_API UCombatLightSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UCombatLightSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Requests through the world's light manager. Returns an invalid handle when there is none */
+	static FCombatLightHandle RequestLight(const UObject* WorldContextObject, const FCombatLightRequest& Request);
+
+	/** Fades out and releases Handle's light, if it is still alive, and resets Handle */
+	static void ReleaseLight(const UObject* WorldContextObject, FCombatLightHandle& Handle, bool bImmediate = false);
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	FCombatLightHandle Request(const FCombatLightRequest& Request);
+	void Release(FCombatLightHandle& Handle, bool bImmediate = false);
+
+	const FCombatLightStats& GetStats() const { return Stats; }
+
+private:
+	struct FLiveRequest
+	{
+		FCombatLightHandle Handle;
+		FCombatLightRequest Request;
+		double StartTime = 0.0;
+		double ReleaseTime = -1.0; // Set once the fade out has started
+		float AppliedIntensity = -1.f;
+		float Score = 0.f;
+		int32 LightIndex = INDEX_NONE;
+	};
+
+	struct FPooledLight
+	{
+		TWeakObjectPtr<ULocalLightComponent> Component;
+		ECombatLightType Type = ECombatLightType::Point;
+		bool bAssigned = false;
+	};
+
+	void UpdateLights();
+	float GetFadedIntensity(const FLiveRequest& Live, double Now) const;
+	int32 AcquireLight(ECombatLightType Type);
+	ULocalLightComponent* CreateLight(ECombatLightType Type);
+	void ApplyRequest(FLiveRequest& Live, ULocalLightComponent* Light);
+	void FreeLight(FLiveRequest& Live);
+
+	TArray<FLiveRequest> Requests;
+	TArray<FPooledLight> Lights;
+	uint32 NextId = 1;
+
+	FCombatLightStats Stats;
+};
@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TimerManager.h"
+
+/**
+ * Lightweight latent action used to write multi-stage combat moves as sequential code.
+ * Steps run in order on the owner's world timer manager. Wait/WaitUntil suspend the
+ * sequence until time has passed or a condition holds. Cancel() stops the move and
+ * runs the Finally handler exactly once, so restore code only has to be written once.
+ *
+ *	QuickAttackMove.Reset()
+ *		.Wait(0.4f)
+ *		.ContinueIf([this]() { return FireBolt(); })
+ *		.Wait(0.3f)
+ *		.Finally([this](bool bWasCancelled) { RestoreMovement(); });
+ *	QuickAttackMove.Start(this);
+ */
+class MYPROJECTTEST2_API FCombatMove
+{
+public:
+	/** Cancels any running sequence and clears its steps so a new one can be built */
+	FCombatMove& Reset();
+
+	/** Runs Action and continues immediately */
+	FCombatMove& Then(TFunction<void()> Action);
+
+	/** Runs Condition and ends the move (not cancelled) if it returns false */
+	FCombatMove& ContinueIf(TFunction<bool()> Condition);
+
+	/** Suspends the move for Seconds of game time */
+	FCombatMove& Wait(float Seconds);
+
+	/** Suspends the move until Condition returns true, polled once per frame. A positive Timeout continues the move anyway */
+	FCombatMove& WaitUntil(TFunction<bool()> Condition, float Timeout = -1.f);
+
+	/** Called once when the move ends, whether it completed, stopped on a ContinueIf or was cancelled */
+	FCombatMove& Finally(TFunction<void(bool bWasCancelled)> Handler);
+
+	void Start(UObject* InOwner);
+	void Cancel();
+
+	bool IsRunning() const { return bIsRunning; }
+	float GetElapsedTime() const;
+
+private:
+	enum class EStepType : uint8
+	{
+		Action,
+		Guard,
+		Delay,
+		Condition
+	};
+
+	struct FStep
+	{
+		EStepType Type = EStepType::Action;
+		TFunction<void()> Action;
+		TFunction<bool()> Condition;
+		float Seconds = 0.f;
+	};
+
+	void Advance();
+	void Finish(bool bWasCancelled);
+	void ScheduleDelay(float Seconds);
+	void SchedulePoll();
+	void PollCondition(uint32 ExpectedGeneration);
+	UWorld* GetWorld() const;
+
+	TArray<FStep> Steps;
+	TFunction<void(bool)> FinallyHandler;
+	TFunction<bool()> PendingCondition;
+	TWeakObjectPtr<UObject> Owner;
+	FTimerHandle WaitTimerHandle;
+	int32 Cursor = 0;
+	uint32 Generation = 0;
+	double StartTime = 0.0;
+	double PendingTimeoutAt = -1.0;
+	bool bIsRunning = false;
+};
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AITypes.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CombatNavigationSubsystem.generated.h"
+
+class AAIController;
+
+struct FCombatNavigationStats
+{
+	uint32 Issued = 0; // Move requests passed on to the controller
+	uint32 Repaths = 0; // Issued for an unchanged goal because it moved or the path was invalidated
+	uint32 Suppressed = 0; // Identical to the move already running
+	uint32 StopsIssued = 0;
+	uint32 StopsSuppressed = 0; // The controller wasn't moving
+};
+
+/**
+ * Every AI move and stop goes through here instead of straight to the controller. The goal each controller is
+ * moving to is kept, and a request for the same goal is dropped while that move is still following a valid path
+ * and the goal actor hasn't moved more than Combat.Nav.RepathDistance since it was requested. Stopping a
+ * controller that isn't moving is dropped as well.
+ */
+UCLASS()
+class MYPROJECTTEST2_API UCombatNavigationSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UCombatNavigationSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Moves through the world's navigation layer, or directly when there is none */
+	static void MoveToActor(AAIController* Controller, AActor* Goal, float AcceptanceRadius = 5.f, bool bCanStrafe = false);
+	static void StopMovement(AAIController* Controller);
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+
+	void RequestMove(AAIController* Controller, AActor* Goal, float AcceptanceRadius, bool bCanStrafe);
+	void RequestStop(AAIController* Controller);
+
+	const FCombatNavigationStats& GetStats() const { return Stats; }
+
+private:
+	struct FActiveMove
+	{
+		TWeakObjectPtr<AActor> Goal;
+		FVector GoalLocation = FVector::ZeroVector; // Where the goal was when the path was requested
+		float AcceptanceRadius = 0.f;
+		bool bCanStrafe = false;
+		FAIRequestID RequestId;
+		bool bAlreadyAtGoal = false;
+	};
+
+	bool IsStillValid(const FActiveMove& Move, const AAIController& Controller) const;
+	static EPathFollowingRequestResult::Type IssueMove(AAIController* Controller, AActor* Goal, float AcceptanceRadius, bool bCanStrafe);
+
+	TMap<TWeakObjectPtr<AAIController>, FActiveMove> ActiveMoves;
+
+	FCombatNavigationStats Stats;
+};
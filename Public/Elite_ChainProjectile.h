@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "TetherComponent.h"
 #include "Elite_ChainProjectile.generated.h"
 
 class AAI_Elite;
@@ -17,8 +18,6 @@ class MYPROJECTTEST2_API AElite_ChainProjectile : public AActor
 public:    
 	AElite_ChainProjectile();
 
-	virtual void Tick(float DeltaTime) override;
-
 	void LaunchChain(APawn* TargetLocation, AAI_Elite* Boss);
 
 protected:
@@ -30,6 +29,9 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
 	UCapsuleComponent* CollisionCapsule;
 
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+	UTetherComponent* Tether;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chain")
 	float ChainSpeed;
 
@@ -37,16 +39,17 @@ protected:
 	float MaxChainLength;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chain")
-	float PullForce;
-	FVector LeftHandLocation;
-	FTimerHandle ChainTimerHandle;
+	float PullForce; // One-off velocity change (cm/s) toward the boss when the chain latches
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Chain")
+	float ChainUnitLength; // World length (cm) of the chain mesh at a Y scale of 1
 
 private:
 
-	void PullPlayer(ACharacter* PlayerCharacter);
+	void UpdateChain(const UTetherComponent& UpdatedTether);
+
+	UFUNCTION()
+	void OnTetherStateChanged(ETetherState NewState);
 
-	AAI_Elite* BossReference;
-	APawn* TargetRef;
-	float CurrentChainLength;
-	bool bIsRetracting;
-};
\ No newline at end of file
+	float LastChainScale = -1.f;
+};
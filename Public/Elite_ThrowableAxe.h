@@ -24,7 +24,7 @@ public:
 	virtual void Tick(float DeltaTime) override;
 
 	void ThrowAxe(FVector TargetLocation, AActor* Boss, AActor* TargetActor);
-	void HitPlayer();
+	void HitPlayer(const FVector& From, const FVector& To);
 	auto OnAxeHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
 	              FVector NormalImpulse, const FHitResult& Hit) -> void;
 	void HandleAxeCollision(AActor* OtherActor);
@@ -36,9 +36,24 @@ private:
 	UPROPERTY(EditDefaultsOnly, Category = "Components")
 	UStaticMeshComponent* AxeMesh;
 
+	UPROPERTY(VisibleAnywhere, Category = "Components")
+	class UNiagaraComponent* TrailComponent;
+
 	UPROPERTY(EditDefaultsOnly, Category = "Movement")
 	float SpinSpeed = 3 * 720.f;
 
+	UPROPERTY(EditDefaultsOnly, Category = "Movement")
+	float AngularSpeed = 300.f; // Degrees per second around the path's center
+
+	UPROPERTY(EditDefaultsOnly, Category = "Damage")
+	float HitRadius = 110.f; // Sweep radius of the axe against the player's capsule
+
+	/** Position on the circular path TimeSinceThrow seconds after release */
+	FVector EvaluatePath(float TimeSinceThrow) const;
+
+	/** Time for one full loop of the path; the axe is removed if it hasn't met the boss by then */
+	float GetLoopDuration() const;
+
 	FVector StartLocation;
 	FVector EndLocation;
 	AActor* BossReference;
@@ -51,5 +66,6 @@ private:
 	float ThrowDuration;
 	float ReturnDuration;
 	FVector Center;
+	FVector PathStartOffset;
 	float Radius;
 };
@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SEnemyHealthBars.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyHealthBarSubsystem.generated.h"
+
+class AAI_Character;
+class SWidget;
+struct FCombatSnapshot;
+
+/**
+ * Health bars for every registered grunt, drawn by one viewport layer instead of a widget component per grunt.
+ * Once per frame, in the combat presentation stage, the bars of damaged enemies are projected with a single
+ * view-projection matrix and handed to the layer, which only repaints when a bar visibly changed.
+ * Bars draining after a hit are advanced in the same pass, so grunts whose health isn't moving cost nothing.
+ */
+UCLASS()
+class MYPROJECTTEST2_API UEnemyHealthBarSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UEnemyHealthBarSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	/** Advances Grunt's health bar drain every frame until it finishes */
+	void AddDrain(AAI_Character* Grunt);
+
+private:
+	void UpdateBars(const FCombatSnapshot& Snapshot);
+	void UpdateDrains();
+	bool EnsureLayer();
+
+	TSharedPtr<SEnemyHealthBars> Layer;
+	TSharedPtr<SWidget> LayerRoot; // What was added to the viewport
+	TArray<FEnemyHealthBar> FrameBars; // Reused every frame
+	TArray<TWeakObjectPtr<AAI_Character>> Draining;
+};
@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FootstepSubsystem.generated.h"
+
+class ACharacter;
+class UAudioComponent;
+class USoundBase;
+
+struct FFootstepSettings
+{
+	USoundBase* Sound = nullptr;
+	float StrideLength = 150.f; // Ground distance between footsteps
+	float Volume = 1.f;
+	float NoiseLoudness = 0.f; // AI hearing loudness of each step, 0 makes no noise
+	bool bCanJoinCrowd = false; // Far away steps fold into the crowd loop instead of playing one-shots
+	TFunction<bool()> CanStep; // Optional extra gate, e.g. no steps mid-roll
+};
+
+struct FFootstepEvent
+{
+	ACharacter* Character = nullptr;
+	FVector Location = FVector::ZeroVector;
+	EPhysicalSurface Surface = SurfaceType_Default; // From the movement component's cached floor
+	bool bInCrowd = false;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnFootstep, const FFootstepEvent&);
+
+/**
+ * Footsteps for every registered character, driven by ground distance covered rather than a timer.
+ * One pass per frame in the combat presentation stage accumulates each character's horizontal movement
+ * while walking and emits a step every stride. Steps read the surface from the cached floor hit, play through the
+ * audio cue manager and report AI noise. Crowd members further than Combat.Footsteps.CrowdDistance from the
+ * listener don't play one-shots; their step rate drives the volume of a single looping crowd layer instead.
+ */
+UCLASS()
+class MYPROJECTTEST2_API UFootstepSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UFootstepSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	void Register(ACharacter* Character, FFootstepSettings Settings);
+	void Unregister(const ACharacter* Character);
+
+	/** Loop played for far away crowd steps. The first one set wins */
+	void SetCrowdLoop(USoundBase* Sound);
+
+	FOnFootstep OnFootstep;
+
+private:
+	struct FWalker
+	{
+		TWeakObjectPtr<ACharacter> Character;
+		FFootstepSettings Settings;
+		FVector LastLocation = FVector::ZeroVector;
+		float Distance = 0.f;
+	};
+
+	void UpdateFootsteps(float DeltaTime);
+	static EPhysicalSurface GetFloorSurface(const FHitResult& FloorHit);
+	void UpdateCrowdLoop(float DeltaTime, int32 CrowdSteps, const FVector& CrowdCenter);
+
+	TArray<FWalker> Walkers;
+
+	UPROPERTY()
+	USoundBase* CrowdLoopSound = nullptr;
+
+	UPROPERTY()
+	UAudioComponent* CrowdLoop = nullptr;
+
+	float CrowdStepRate = 0.f; // Smoothed steps per second
+	FVector CrowdLocation = FVector::ZeroVector;
+};
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "HealingVial.generated.h"
+
+class UStaticMesh;
+class UStaticMeshComponent;
+
+/**
+ * A thrown healing vial. The player keeps a few of these spawned and hidden, so a throw only moves one into place and
+ * hands it to physics. Physics and CCD are set up once at construction; the owner binds the mesh's hit event once
+ * when it creates the pool. The impact flash is borrowed from the combat light manager.
+ */
+UCLASS()
+class MYPROJECTTEST2_API AHealingVial : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AHealingVial();
+
+	UStaticMeshComponent* GetVialMesh() const { return VialMesh; }
+	bool IsInUse() const { return bInUse; }
+
+	/** Shows the vial at Transform and throws it with an impulse and spin, both as velocity changes */
+	void Throw(UStaticMesh* Mesh, const FTransform& Transform, const FVector& Impulse, const FVector& Torque);
+
+	/** Flashes an impact light where the vial broke and puts the vial back in the pool */
+	void Shatter(const FVector& Location);
+
+	/** Stops and hides everything; the vial is free for the next throw */
+	void ReturnToPool();
+
+private:
+	UPROPERTY(VisibleAnywhere, Category = "Components")
+	UStaticMeshComponent* VialMesh;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Healing")
+	float Lifetime = 5.f; // Seconds before an unbroken vial is put back
+
+	UPROPERTY(EditDefaultsOnly, Category = "Healing")
+	float ImpactFlashDuration = 0.3f;
+
+	FTimerHandle LifetimeTimerHandle;
+	bool bInUse = false;
+};
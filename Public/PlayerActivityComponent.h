@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "PlayerActivityComponent.generated.h"
+
+class AMyProjectTest2Character;
+
+/**
+ * Base for the player's on-demand components. Tick starts disabled, Wake() turns it on when
+ * the owner starts something that needs per-frame work, and the component turns its own tick
+ * off again as soon as HasWork() reports it is idle.
+ * Gameplay that must not depend on frame rate goes in TickSimulation, which runs on the combat
+ * sim clock's fixed steps; TickActivity runs once per rendered frame.
+ */
+UCLASS(Abstract)
+class MYPROJECTTEST2_API UPlayerActivityComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UPlayerActivityComponent();
+
+	void Wake();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void TickSimulation(float FixedStep) {}
+	virtual void TickActivity(float DeltaTime) {}
+	virtual bool HasWork() const { return false; }
+
+	UPROPERTY()
+	AMyProjectTest2Character* Character;
+};
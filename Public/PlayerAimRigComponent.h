@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlayerActivityComponent.h"
+#include "PlayerAimRigComponent.generated.h"
+
+/**
+ * Drives the follow camera: the bow aim pose while aiming, otherwise keeps the camera looking at the neck socket.
+ * Goes idle once the view has settled and wakes again on move, look or aim input.
+ */
+UCLASS(ClassGroup=(Player), meta=(BlueprintSpawnableComponent))
+class MYPROJECTTEST2_API UPlayerAimRigComponent : public UPlayerActivityComponent
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void TickSimulation(float FixedStep) override;
+	virtual void TickActivity(float DeltaTime) override;
+	virtual bool HasWork() const override;
+
+private:
+	void LookAtNeck();
+
+	FVector LastCameraLocation = FVector::ZeroVector;
+	FVector LastNeckLocation = FVector::ZeroVector;
+	bool bViewSettled = false;
+};
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlayerActivityComponent.h"
+#include "PlayerAudioCueComponent.generated.h"
+
+class UAudioComponent;
+
+/**
+ * The heartbeat at low health, as one persistent looping voice whose volume and rate follow the display health.
+ * Only ticks when the display health has moved enough to change the loop. Footsteps come from UFootstepSubsystem.
+ */
+UCLASS(ClassGroup=(Player), meta=(BlueprintSpawnableComponent))
+class MYPROJECTTEST2_API UPlayerAudioCueComponent : public UPlayerActivityComponent
+{
+	GENERATED_BODY()
+
+public:
+	/** Float parameter set on the heartbeat sound, 0 at the threshold up to 1 at zero health */
+	UPROPERTY(EditAnywhere, Category = "Audio")
+	FName HeartRateParameter = TEXT("HeartRate");
+
+protected:
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void TickActivity(float DeltaTime) override;
+	virtual bool HasWork() const override;
+
+private:
+	float GetHealthFraction() const;
+	void UpdateHeartbeat();
+
+	UPROPERTY()
+	UAudioComponent* HeartbeatLoop = nullptr;
+
+	bool bHeartbeatPlaying = false;
+	float AppliedHealthFraction = 1.f;
+};
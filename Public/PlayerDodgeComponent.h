@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlayerActivityComponent.h"
+#include "PlayerDodgeComponent.generated.h"
+
+/** Moves the player through rolls and melee attack lunges. Only ticks while one of them is in progress */
+UCLASS(ClassGroup=(Player), meta=(BlueprintSpawnableComponent))
+class MYPROJECTTEST2_API UPlayerDodgeComponent : public UPlayerActivityComponent
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void TickActivity(float DeltaTime) override;
+	virtual bool HasWork() const override;
+
+private:
+	void UpdateAttackLunge(float DeltaTime);
+	void UpdateRoll(float DeltaTime);
+};
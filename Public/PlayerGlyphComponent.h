@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlayerActivityComponent.h"
+#include "PlayerGlyphComponent.generated.h"
+
+class UMaterialInstanceDynamic;
+class UMaterialParameterCollection;
+class UMaterialParameterCollectionInstance;
+
+/**
+ * Spins and fades the healing glyph. Only ticks while the glyph is shown.
+ * The fade goes through FadeParameters when set, otherwise through one dynamic material created on the first heal
+ * and reused after, so a heal cycle allocates nothing once warmed up.
+ */
+UCLASS(ClassGroup=(Player), meta=(BlueprintSpawnableComponent))
+class MYPROJECTTEST2_API UPlayerGlyphComponent : public UPlayerActivityComponent
+{
+	GENERATED_BODY()
+
+#if WITH_DEV_AUTOMATION_TESTS
+	friend class FPlayerGlyphHealCycleAllocationTest;
+#endif
+
+public:
+	/** Shows the glyph at full strength and starts its hold and fade */
+	void Show();
+
+	/** Optional collection driving the glyph fade for every material that reads it */
+	UPROPERTY(EditAnywhere, Category = "Healing")
+	UMaterialParameterCollection* FadeParameters = nullptr;
+
+	UPROPERTY(EditAnywhere, Category = "Healing")
+	FName OpacityParameter = TEXT("Opacity");
+
+	/** Collection scalar set to the glyph light's current intensity, if the collection has it */
+	UPROPERTY(EditAnywhere, Category = "Healing")
+	FName IntensityParameter = TEXT("GlyphIntensity");
+
+protected:
+	virtual void TickActivity(float DeltaTime) override;
+	virtual bool HasWork() const override;
+
+private:
+	void ApplyFade(float FadeFactor);
+
+	UPROPERTY()
+	UMaterialInstanceDynamic* GlyphMaterial = nullptr;
+
+	UPROPERTY()
+	UMaterialParameterCollectionInstance* FadeParametersInstance = nullptr;
+};
@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "PlayerHUDViewModel.generated.h"
+
+UENUM(BlueprintType)
+enum class EPlayerHUDField : uint8
+{
+	Health,
+	DisplayHealth,
+	Stamina,
+	Arrows,
+	CrossbowArrows,
+	HealthVials,
+	ArrowRestock,
+	CrossbowRestock,
+	VialRestock
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnPlayerHUDFieldChanged, EPlayerHUDField, Field);
+
+/**
+ * Everything the player HUD shows, pushed by the character instead of polled by widget bindings.
+ * Setters only store and broadcast when the value moved by at least the field's display step, so a frame where
+ * nothing visible changed costs the HUD nothing.
+ */
+UCLASS(BlueprintType)
+class MYPROJECTTEST2_API UPlayerHUDViewModel : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintAssignable, Category = "HUD")
+	FOnPlayerHUDFieldChanged OnFieldChanged;
+
+	void SetHealth(float Value, float MaxValue);
+	void SetDisplayHealth(float Value);
+	void SetStamina(float Value, float MaxValue);
+	void SetArrows(int32 Value, int32 MaxValue);
+	void SetCrossbowArrows(int32 Value, int32 MaxValue);
+	void SetHealthVials(int32 Value, int32 MaxValue);
+	void SetArrowRestock(float Progress);
+	void SetCrossbowRestock(float Progress);
+	void SetVialRestock(float Progress);
+
+	UFUNCTION(BlueprintPure, Category = "HUD")
+	float GetHealthPercent() const { return MaxHealth > 0.f ? Health / MaxHealth : 0.f; }
+
+	UFUNCTION(BlueprintPure, Category = "HUD")
+	float GetDisplayHealthPercent() const { return MaxHealth > 0.f ? DisplayHealth / MaxHealth : 0.f; }
+
+	UFUNCTION(BlueprintPure, Category = "HUD")
+	float GetStaminaPercent() const { return MaxStamina > 0.f ? Stamina / MaxStamina : 0.f; }
+
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	float Health = 100.f;
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	float MaxHealth = 100.f;
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	float DisplayHealth = 100.f; // Eases toward Health after a hit or heal
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	float Stamina = 400.f;
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	float MaxStamina = 400.f;
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	int32 Arrows = 0;
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	int32 MaxArrows = 0;
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	int32 CrossbowArrows = 0;
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	int32 MaxCrossbowArrows = 0;
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	int32 HealthVials = 0;
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	int32 MaxHealthVials = 0;
+
+	// Restock timers as 0-1 progress toward the next item; 0 while full
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	float ArrowRestock = 0.f;
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	float CrossbowRestock = 0.f;
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	float VialRestock = 0.f;
+
+private:
+	void SetPair(float& Field, float& MaxField, float Value, float MaxValue, float Step, EPlayerHUDField Id);
+	void SetPair(int32& Field, int32& MaxField, int32 Value, int32 MaxValue, EPlayerHUDField Id);
+	void SetProgress(float& Field, float Progress, EPlayerHUDField Id);
+};
@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "PlayerHUDViewModel.h"
+#include "PlayerHUDWidget.generated.h"
+
+/**
+ * Base for the player HUD. Instead of property bindings polled every frame, the widget listens to the owning
+ * character's view model and updates its elements in OnHUDFieldChanged, only when a shown value changes.
+ * Put the HUD's contents under an invalidation panel so unchanged frames reuse the cached layout and draw.
+ */
+UCLASS(Abstract)
+class MYPROJECTTEST2_API UPlayerHUDWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void NativeConstruct() override;
+	virtual void NativeDestruct() override;
+
+	/** Called once per field on construct, then whenever that field changes */
+	UFUNCTION(BlueprintImplementableEvent, Category = "HUD")
+	void OnHUDFieldChanged(EPlayerHUDField Field);
+
+	UPROPERTY(BlueprintReadOnly, Category = "HUD")
+	UPlayerHUDViewModel* ViewModel = nullptr;
+
+private:
+	UFUNCTION()
+	void HandleFieldChanged(EPlayerHUDField Field);
+};
@@ -0,0 +1,18 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlayerActivityComponent.h"
+#include "PlayerInventoryComponent.generated.h"
+
+/** Restocks arrows, crossbow bolts and healing vials over time. Idle while everything is full */
+UCLASS(ClassGroup=(Player), meta=(BlueprintSpawnableComponent))
+class MYPROJECTTEST2_API UPlayerInventoryComponent : public UPlayerActivityComponent
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void TickActivity(float DeltaTime) override;
+	virtual bool HasWork() const override;
+};
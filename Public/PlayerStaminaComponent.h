@@ -0,0 +1,18 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlayerActivityComponent.h"
+#include "PlayerStaminaComponent.generated.h"
+
+/** Stamina regeneration, depletion and sprint drain. Idle once stamina is full and nothing is draining it */
+UCLASS(ClassGroup=(Player), meta=(BlueprintSpawnableComponent))
+class MYPROJECTTEST2_API UPlayerStaminaComponent : public UPlayerActivityComponent
+{
+	GENERATED_BODY()
+
+protected:
+	virtual void TickSimulation(float FixedStep) override;
+	virtual bool HasWork() const override;
+};
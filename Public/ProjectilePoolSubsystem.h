@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ProjectilePoolSubsystem.generated.h"
+
+class AProjectile_Arrow_Base;
+
+struct FProjectilePoolStats
+{
+	uint32 Hits = 0; // Acquires served from the free list
+	uint32 Misses = 0; // Acquires that had to spawn a new actor
+	uint32 Recycled = 0; // Acquires that reclaimed a live arrow because the pool was at its cap
+	int32 Live = 0;
+	int32 Free = 0;
+};
+
+/**
+ * Free-list pool for arrows and bolts. Fired arrows are acquired instead of spawned, and stuck
+ * arrows stay in the world until the pool reaches Combat.ProjectilePool.MaxArrows, at which point
+ * the oldest stuck arrow (or the oldest in flight, if none are stuck) is recycled for the new shot.
+ */
+UCLASS()
+class MYPROJECTTEST2_API UProjectilePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UProjectilePoolSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+
+	/** Spawns Count inactive arrows of Class up front so the first shots don't hitch */
+	void Prewarm(TSubclassOf<AProjectile_Arrow_Base> Class, int32 Count);
+
+	/** Returns an active arrow at Transform, reusing a pooled one when possible */
+	AProjectile_Arrow_Base* Acquire(TSubclassOf<AProjectile_Arrow_Base> Class, const FTransform& Transform, AActor* Owner, APawn* Instigator);
+
+	/** Deactivates Arrow and puts it back on its class's free list */
+	void Release(AProjectile_Arrow_Base* Arrow);
+
+	/** Called by arrows once they have stuck into something, making them the first candidates for recycling */
+	void NotifyStuck(AProjectile_Arrow_Base* Arrow);
+
+	const FProjectilePoolStats& GetStats() const { return Stats; }
+
+private:
+	struct FClassPool
+	{
+		TArray<TWeakObjectPtr<AProjectile_Arrow_Base>> Free;
+	};
+
+	AProjectile_Arrow_Base* SpawnPooled(UClass* Class, const FTransform& Transform);
+	AProjectile_Arrow_Base* ReclaimOldest();
+	void PruneInvalid();
+	void UpdateStats();
+
+	TMap<TObjectKey<UClass>, FClassPool> Pools;
+	TArray<TWeakObjectPtr<AProjectile_Arrow_Base>> LiveArrows; // Oldest first
+	TArray<TWeakObjectPtr<AProjectile_Arrow_Base>> StuckArrows; // Oldest first
+	FProjectilePoolStats Stats;
+};
@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ProjectileSimSubsystem.generated.h"
+
+class AProjectile_Arrow_Base;
+class USoundBase;
+struct FCombatSnapshot;
+
+/**
+ * Kinematic flight for every in-flight arrow, stored as parallel arrays instead of one rigid body per arrow.
+ * Each combat sim step integrates all arrows and sweeps them (in parallel when Combat.Projectiles.ParallelSweeps is set).
+ * Hits are only recorded during the sim; they are resolved in one ordered batch in the damage resolution stage, where
+ * all arrows striking the same target in a step become one damage event and impact effects are coalesced by location.
+ * Arrow actors are otherwise only touched to sync their transform during presentation.
+ */
+UCLASS()
+class MYPROJECTTEST2_API UProjectileSimSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UProjectileSimSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	/** Starts (or redirects) Arrow's flight from its current location */
+	void Launch(AProjectile_Arrow_Base* Arrow, const FVector& Velocity, float GravityScale, float SweepRadius);
+
+	/**
+	 * Fires one arrow of Class per direction from Origin. Arrows come from the projectile pool, are set up and
+	 * added to the sim in a single pass, and ReleaseSound plays once for the whole volley. Returns how many were fired.
+	 */
+	int32 FireVolley(TSubclassOf<AProjectile_Arrow_Base> Class, const FVector& Origin, TConstArrayView<FVector> Directions,
+		float Speed, float Damage, APawn* Instigator, USoundBase* ReleaseSound = nullptr);
+
+	/** Stops simulating Arrow. Safe to call while stepping or resolving hits */
+	void Remove(const AProjectile_Arrow_Base* Arrow);
+
+	int32 GetNumInFlight() const { return Arrows.Num(); }
+
+	/** Fires Volleys volleys of ArrowsPerVolley arrows dealing Damage, one every Interval frames, and logs the projectile frame cost */
+	void StartVolleyBenchmark(TSubclassOf<AProjectile_Arrow_Base> Class, int32 ArrowsPerVolley, int32 Volleys, int32 Interval, float Damage);
+
+private:
+	// Cold per-arrow data, only read when building the sweep
+	struct FFlightQuery
+	{
+		TWeakObjectPtr<const AActor> IgnoredOwner;
+		TEnumAsByte<ECollisionChannel> Channel = ECC_WorldDynamic;
+		FCollisionResponseContainer Responses;
+	};
+
+	struct FPendingHit
+	{
+		TWeakObjectPtr<AProjectile_Arrow_Base> Arrow;
+		FHitResult Hit;
+		FVector Velocity = FVector::ZeroVector;
+		uint64 Order = 0; // Sim step in the high bits, flight slot in the low bits
+		uint32 PoolGeneration = 0; // The arrow's generation when it hit
+	};
+
+	struct FVolleyBenchmark
+	{
+		TSubclassOf<AProjectile_Arrow_Base> Class;
+		float Damage = 0.f;
+		int32 ArrowsPerVolley = 0;
+		int32 Volleys = 0;
+		int32 VolleysLeft = 0;
+		int32 Interval = 0;
+		int32 Frame = 0;
+		double FireMs = 0.0;
+		double SimMs = 0.0;
+		double ResolveMs = 0.0;
+		double PresentMs = 0.0;
+		double FrameMs = 0.0;
+		double PeakFrameMs = 0.0;
+		int32 SavedMaxArrows = INDEX_NONE; // Pool cap to put back when the benchmark ends, if it raised it
+		bool bActive = false;
+	};
+
+	int32 AddSlot(AProjectile_Arrow_Base* Arrow);
+	void InitFlight(int32 Index, AProjectile_Arrow_Base* Arrow, const FVector& Velocity, float GravityScale, float SweepRadius);
+	void Step(float FixedStep);
+	void ResolveHits();
+	void Present(float Alpha);
+	void TickVolleyBenchmark(double PresentMs);
+	void EndVolleyBenchmark();
+	void RemoveAtSwap(int32 Index);
+	void Compact();
+
+	// Hot data, one entry per arrow in flight
+	TArray<TWeakObjectPtr<AProjectile_Arrow_Base>> Arrows;
+	TArray<FVector> Positions;
+	TArray<FVector> PreviousPositions;
+	TArray<FVector> Velocities;
+	TArray<float> Gravity;
+	TArray<float> Ages;
+	TArray<float> Radii;
+	TArray<FFlightQuery> Queries;
+
+	// Per-step scratch, kept to avoid reallocating every step
+	TArray<FVector> SweepEnds;
+	TArray<FCollisionQueryParams> SweepParams;
+	TArray<uint8> SweepDidHit;
+	TArray<uint32> SweepGenerations;
+
+	// Filled by sweep workers, drained once per frame by ResolveHits
+	TQueue<FPendingHit, EQueueMode::Mpsc> PendingHits;
+	TArray<FPendingHit> ResolveBatch;
+	uint32 StepCounter = 0;
+
+	// Arrows that ran out of lifetime during the sim, returned to the pool with the hits
+	struct FExpiredArrow
+	{
+		TWeakObjectPtr<AProjectile_Arrow_Base> Arrow;
+		uint32 PoolGeneration = 0;
+	};
+	TArray<FExpiredArrow> ExpiredArrows;
+
+	FVolleyBenchmark Benchmark;
+
+	bool bIsStepping = false;
+	bool bNeedsCompact = false;
+};
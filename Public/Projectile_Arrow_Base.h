@@ -7,6 +7,8 @@
 #include "NiagaraSystem.h" 
 #include "Projectile_Arrow_Base.generated.h"
 
+class UNiagaraComponent;
+
 
 UCLASS()
 class MYPROJECTTEST2_API AProjectile_Arrow_Base : public AActor
@@ -20,16 +22,27 @@ public:
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void FellOutOfWorld(const UDamageType& DamageType) override;
 
 public:	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
 	UStaticMeshComponent* GetArrowMesh() const { return ArrowMesh; }
 	void SetVelocity(const FVector& Vector);
+	/** Sets velocity, facing and trail without registering with the projectile sim, for callers that launch in bulk */
+	void PrepareFlight(const FVector& Vector);
+	float GetGravityScale() const { return GravityScale; }
+	float GetSweepRadius() const { return SweepRadius; }
 	
 	void SetDamage(float Damage);
+	float GetDamage() const { return DamageAmount; }
 	void Scale(double X);
 
+	// Pool lifecycle, driven by UProjectilePoolSubsystem
+	void ActivateFromPool(const FTransform& Transform);
+	void DeactivateToPool();
+	/** Changes every time the arrow enters or leaves the pool, so holders can tell it's still the shot they fired */
+	uint32 GetPoolGeneration() const { return PoolGeneration; }
+
 	UPROPERTY(EditAnywhere, Category="Effects")
 	UNiagaraSystem* HitEffect;
 
@@ -41,18 +54,41 @@ public:
 
 	bool hasCollided = false;  // Whether the arrow has collided with something
 
+	// Impacts are recorded during the projectile sim and resolved in one batch in the damage resolution stage
+	void MarkImpactPending();
+	bool IsImpactPending() const { return bImpactPending; }
+	/** Returns the damage this arrow deals and clears it, so a hit can never count twice */
+	float ConsumeImpactDamage();
+	void PlayImpactEffects(const FHitResult& Hit);
+	void ResolveImpact(const FHitResult& Hit, const FVector& ImpactVelocity);
+
 private:
 	UPROPERTY(VisibleAnywhere, Category = "Components")
 	class UStaticMeshComponent* ArrowMesh;
 
+	UPROPERTY(VisibleAnywhere, Category = "Components")
+	class UNiagaraComponent* TrailComponent;
+
 	FVector Velocity;  // The velocity of the arrow
 	float Speed;  // Arrow speed
+	bool bImpactPending = false;
+	bool bReleaseWhenTrailFinished = false;  // Instanced on impact; back to the pool once the trail has faded
+	uint32 PoolGeneration = 0;
+
+	UPROPERTY(EditAnywhere, Category = "Flight")
+	float GravityScale = 1.0f;
+
+	UPROPERTY(EditAnywhere, Category = "Flight")
+	float SweepRadius = 0.0f;  // 0 traces a line, anything larger sweeps a sphere
 
 	UPROPERTY(EditAnywhere, Category = "Damage")
 	float DamageAmount = 70.0f;  // Amount of damage the arrow deals
 
-	UFUNCTION()
-	void OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
 	void StopArrowMovement();
-	void AttachArrowToTarget(AActor* HitActor, UPrimitiveComponent* HitComponent, const FHitResult& Hit);
+
+	UFUNCTION()
+	void OnTrailFinished(UNiagaraComponent* FinishedComponent);
+
+	/** Returns true if the arrow was turned into a stuck-arrow instance rather than attached as an actor */
+	bool AttachArrowToTarget(AActor* HitActor, UPrimitiveComponent* HitComponent, const FHitResult& Hit);
 };
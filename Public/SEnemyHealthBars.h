@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SLeafWidget.h"
+
+struct FEnemyHealthBar
+{
+	FVector2D Position = FVector2D::ZeroVector; // Bar center in viewport pixels
+	float Scale = 1.f;
+	float Fraction = 1.f; // Fill, 0 to 1
+};
+
+/**
+ * Every enemy health bar in one leaf widget, painted as two boxes per bar. The bars only change through SetBars,
+ * which invalidates paint when something visibly moved or changed; otherwise the cached draw is reused.
+ */
+class MYPROJECTTEST2_API SEnemyHealthBars : public SLeafWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SEnemyHealthBars) {}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	/** Takes this frame's bars, swapping NewBars with the previous ones so neither array reallocates */
+	void SetBars(TArray<FEnemyHealthBar>& NewBars);
+
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect,
+		FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+
+private:
+	static bool LooksSame(const FEnemyHealthBar& A, const FEnemyHealthBar& B);
+
+	TArray<FEnemyHealthBar> Bars;
+	const FSlateBrush* Brush = nullptr;
+};
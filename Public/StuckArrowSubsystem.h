@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "StuckArrowSubsystem.generated.h"
+
+class UHierarchicalInstancedStaticMeshComponent;
+class UStaticMesh;
+
+/**
+ * Keeps spent arrows as instances instead of actors. Arrows stuck to the same component, bone and mesh share one
+ * hierarchical instanced static mesh attached there, so they follow the target and vanish with it. A global FIFO
+ * caps the number of visible stuck arrows (Combat.StuckArrows.MaxInstances); evicted slots are hidden and reused.
+ * The FIFO is a ring buffer sized to the cap, so adding an arrow at the cap costs one eviction, not a shuffle.
+ */
+UCLASS()
+class MYPROJECTTEST2_API UStuckArrowSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UStuckArrowSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+
+	/** Adds a stuck arrow at WorldTransform, attached to Surface (at AttachName, if set). Returns false if it can't be instanced */
+	bool AddStuckArrow(UStaticMesh* Mesh, const FTransform& WorldTransform, USceneComponent* Surface, FName AttachName);
+
+	int32 GetNumStuckArrows() const { return FifoCount; }
+
+private:
+	struct FGroupKey
+	{
+		TObjectKey<USceneComponent> Surface;
+		FName AttachName;
+		TObjectKey<UStaticMesh> Mesh;
+
+		bool operator==(const FGroupKey& Other) const
+		{
+			return Surface == Other.Surface && AttachName == Other.AttachName && Mesh == Other.Mesh;
+		}
+
+		friend uint32 GetTypeHash(const FGroupKey& Key)
+		{
+			return HashCombine(HashCombine(GetTypeHash(Key.Surface), GetTypeHash(Key.AttachName)), GetTypeHash(Key.Mesh));
+		}
+	};
+
+	struct FGroup
+	{
+		TWeakObjectPtr<UHierarchicalInstancedStaticMeshComponent> Instances;
+		TArray<int32> FreeIndices; // Hidden slots left by eviction, reused before adding new instances
+		uint32 Generation = 0; // Changes whenever the group gets a new instance component
+	};
+
+	struct FStuckInstance
+	{
+		FGroupKey Key;
+		uint32 Generation = 0;
+		int32 Index = INDEX_NONE;
+	};
+
+	FGroup* FindOrCreateGroup(const FGroupKey& Key, UStaticMesh* Mesh, USceneComponent* Surface);
+	void ResizeFifo(int32 Capacity);
+	void EvictOldest();
+
+	TMap<FGroupKey, FGroup> Groups;
+	TArray<FStuckInstance> Fifo; // Ring buffer of Combat.StuckArrows.MaxInstances slots, oldest at FifoHead
+	int32 FifoHead = 0;
+	int32 FifoCount = 0;
+	uint32 NextGroupGeneration = 0;
+};
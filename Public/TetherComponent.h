@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "TetherComponent.generated.h"
+
+class USkeletalMeshComponent;
+
+UENUM(BlueprintType)
+enum class ETetherState : uint8
+{
+	Idle,
+	Extending,
+	Latched,
+	Retracting
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnTetherStateChangedSignature, ETetherState, NewState);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnTetherUpdated, const class UTetherComponent&);
+
+/**
+ * A line from a socket on a skeletal mesh to a target actor that extends, latches on and retracts.
+ * The socket's bone index is cached once and read from the already-evaluated component space pose, and the tether
+ * length is a closed-form function of time in the current state. Pull is applied through the target's movement
+ * component once, when the tether latches. Chains, grapples and beams build their visuals on OnTetherUpdated.
+ */
+UCLASS(ClassGroup=(Combat), meta=(BlueprintSpawnableComponent))
+class MYPROJECTTEST2_API UTetherComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UTetherComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Starts extending from SocketName on SourceMesh towards Target */
+	void Fire(USkeletalMeshComponent* SourceMesh, FName SocketName, AActor* Target);
+
+	/** Starts retracting from wherever the tether is now */
+	void Release();
+
+	ETetherState GetState() const { return State; }
+	float GetLength() const { return CurrentLength; }
+	const FVector& GetSourceLocation() const { return SourceLocation; }
+	const FVector& GetDirection() const { return Direction; }
+	FVector GetTipLocation() const { return SourceLocation + Direction * CurrentLength; }
+
+	UPROPERTY(BlueprintAssignable, Category = "Tether")
+	FOnTetherStateChangedSignature OnStateChanged;
+
+	/** Broadcast every tick while the tether is active, after source, direction and length are updated */
+	FOnTetherUpdated OnTetherUpdated;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tether")
+	float ExtendSpeed = 3000.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tether")
+	float RetractSpeed = 4000.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tether")
+	float MaxLength = 1200.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tether")
+	float LatchedDuration = 0.3f; // How long the tether holds on before retracting
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tether")
+	float PullStrength = 0.f; // Velocity change applied once to a character target when the tether latches
+
+private:
+	void SetState(ETetherState NewState);
+	bool UpdateSource();
+	void ApplyPull() const;
+
+	TWeakObjectPtr<USkeletalMeshComponent> Source;
+	TWeakObjectPtr<AActor> Target;
+	int32 SourceBoneIndex = INDEX_NONE;
+	FTransform SocketLocalTransform = FTransform::Identity; // Socket offset from its bone, identity when attached to a bone
+
+	ETetherState State = ETetherState::Idle;
+	double StateStartTime = 0.0;
+	float StateStartLength = 0.f;
+	float CurrentLength = 0.f;
+	FVector SourceLocation = FVector::ZeroVector;
+	FVector Direction = FVector::ForwardVector;
+};